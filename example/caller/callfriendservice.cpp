@@ -1,19 +1,24 @@
 #include <iostream>
 #include "mprpcapplication.h"
 #include "friend.pb.h"
+#include "parallelchannel.h"
+#include <thread>
+#include <vector>
 
 int main(int argc, char **argv)
 {
     MprpcApplication::Init(argc, argv);
 
-    fixbug::FriendServiceRpc_Stub stub(new MprpcChannel());
+    // 流水线模式：多个线程的调用共用一条连接，不必等前一个响应返回
+    fixbug::FriendServiceRpc_Stub stub(new MprpcChannel(MprpcChannel::kPipelined));
 
     fixbug::GetFriendsListRequest request;
     request.set_userid(1000);
 
     fixbug::GetFriendsListResponse response;
     MprpcController controller;
-    stub.GetFriendList(nullptr, &request, &response, nullptr);
+    controller.SetTimeout(1000); // 1 秒内没有响应则调用失败
+    stub.GetFriendList(&controller, &request, &response, nullptr);
 
     if (controller.Failed())
     {
@@ -36,5 +41,44 @@ int main(int argc, char **argv)
         }
     }
 
+    // 并发调用：请求在同一条连接上连续发出，响应按 request_id 各自匹配
+    std::vector<std::thread> callers;
+    for (int i = 0; i < 4; ++i)
+    {
+        callers.emplace_back([&stub, i]()
+                             {
+            fixbug::GetFriendsListRequest req;
+            req.set_userid(1000 + i);
+            fixbug::GetFriendsListResponse rsp;
+            MprpcController ctrl;
+            stub.GetFriendList(&ctrl, &req, &rsp, nullptr);
+            std::cout << "userid " << 1000 + i << (ctrl.Failed() ? " failed: " + ctrl.ErrorText() : " ok") << std::endl; });
+    }
+    for (std::thread &caller : callers)
+    {
+        caller.join();
+    }
+
+    // 并行调用：同一请求发给每个服务端，合并所有好友，任意两个服务端成功即返回
+    ParallelChannel parallel;
+    const google::protobuf::MethodDescriptor *getFriendList =
+        fixbug::FriendServiceRpc::descriptor()->FindMethodByName("GetFriendList");
+    MprpcController parallelController;
+    parallelController.SetTimeout(1000);
+    size_t providers = parallel.AddAllProviders(getFriendList, &request, &parallelController);
+    std::vector<std::string> friends;
+    parallel.Call(&parallelController, [&friends](size_t index, const google::protobuf::Message &rsp)
+                  {
+        const fixbug::GetFriendsListResponse &friendsRsp = static_cast<const fixbug::GetFriendsListResponse &>(rsp);
+        friends.insert(friends.end(), friendsRsp.friends().begin(), friendsRsp.friends().end()); }, std::min<size_t>(providers, 2));
+    if (parallelController.Failed())
+    {
+        std::cout << "rpc parallel GetFriendList error: " << parallelController.ErrorText() << std::endl;
+    }
+    else
+    {
+        std::cout << "rpc parallel GetFriendList merged " << friends.size() << " friends from " << providers << " providers" << std::endl;
+    }
+
     return 0;
 }
\ No newline at end of file
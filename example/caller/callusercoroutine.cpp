@@ -0,0 +1,55 @@
+#include <iostream>
+#include <vector>
+#include "mprpcapplication.h"
+#include "rpccoroutine.h"
+#include "user.pb.h"
+
+// rpccoroutine.h 在未开启协程支持时为空，这里直接报错而不是给出大量未定义的符号
+#ifndef __cpp_impl_coroutine
+#error "callusercoroutine.cpp requires C++20 coroutines (-std=c++20)"
+#endif
+
+// 协程中依次调用 Login 和 Register，等待响应期间不占用线程
+static RpcTask<bool> LoginAndRegister(RpcExecutor &executor, fixbug::UserServiceRpc_Stub &stub, int id)
+{
+    MprpcController controller;
+    fixbug::LoginRequest request;
+    request.set_name("user" + std::to_string(id));
+    request.set_pwd("123456");
+    fixbug::LoginResponse response =
+        co_await RpcCall(executor, stub, &fixbug::UserServiceRpc_Stub::Login, &controller, request);
+    if (controller.Failed() || response.result().errcode() != 0)
+    {
+        std::cout << "rpc login error: " << controller.ErrorText() << std::endl;
+        co_return false;
+    }
+
+    controller.Reset();
+    fixbug::RegisterRequest req;
+    req.set_id(id);
+    req.set_name(request.name());
+    req.set_pwd(request.pwd());
+    fixbug::RegisterResponse rsp =
+        co_await RpcCall(executor, stub, &fixbug::UserServiceRpc_Stub::Register, &controller, req);
+    co_return !controller.Failed() && rsp.result().errcode() == 0;
+}
+
+int main(int argc, char **argv)
+{
+    MprpcApplication::Init(argc, argv);
+
+    // 一个执行器线程即可同时推进所有协程
+    RpcExecutor executor(1);
+    fixbug::UserServiceRpc_Stub stub(new MprpcChannel(MprpcChannel::kPipelined));
+
+    std::vector<std::future<bool>> results;
+    for (int i = 0; i < 10; ++i)
+    {
+        results.push_back(RpcSpawn(executor, LoginAndRegister(executor, stub, i)));
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        std::cout << "user" << i << (results[i].get() ? " success" : " failed") << std::endl;
+    }
+    return 0;
+}
@@ -1,21 +1,35 @@
 #include <iostream>
 #include "mprpcapplication.h"
 #include "user.pb.h"
+#include <future>
+
+// 异步 Login 的完成回调
+static void OnLoginDone(fixbug::LoginResponse *response, std::promise<void> *finished)
+{
+    std::cout << "rpc async login response errcode: " << response->result().errcode() << std::endl;
+    finished->set_value();
+}
 
 int main(int argc, char **argv)
 {
     MprpcApplication::Init(argc, argv);
 
-    fixbug::UserServiceRpc_Stub stub(new MprpcChannel());
+    // 两次调用复用同一条长连接
+    fixbug::UserServiceRpc_Stub stub(new MprpcChannel(true));
 
     fixbug::LoginRequest request;
     request.set_name("zhang san");
     request.set_pwd("123456");
 
     fixbug::LoginResponse response;
-    stub.Login(nullptr, &request, &response, nullptr);
+    MprpcController loginController;
+    stub.Login(&loginController, &request, &response, nullptr);
 
-    if (response.result().errcode() == 0)
+    if (loginController.Failed())
+    {
+        std::cout << "rpc login error: " << loginController.ErrorText() << std::endl;
+    }
+    else if (response.result().errcode() == 0)
     {
         std::cout << "rpc login response success" << response.success() << std::endl;
     }
@@ -29,8 +43,13 @@ int main(int argc, char **argv)
     req.set_name("mmppp");
     req.set_pwd("99888");
     fixbug::RegisterResponse rsp;
-    stub.Register(nullptr, &req, &rsp, nullptr);
-    if (rsp.result().errcode() == 0)
+    MprpcController registerController;
+    stub.Register(&registerController, &req, &rsp, nullptr);
+    if (registerController.Failed())
+    {
+        std::cout << "rpc register error: " << registerController.ErrorText() << std::endl;
+    }
+    else if (rsp.result().errcode() == 0)
     {
         std::cout << "rpc register response success" << response.success() << std::endl;
     }
@@ -38,5 +57,40 @@ int main(int argc, char **argv)
     {
         std::cout << "rpc register response error" << response.result().errcode() << std::endl;
     }
+
+    // 批量调用：多个 Login 请求放在一帧里发送
+    MprpcChannel channel(true);
+    const google::protobuf::MethodDescriptor *login = fixbug::UserServiceRpc::descriptor()->FindMethodByName("Login");
+    fixbug::LoginRequest batchReq[3];
+    fixbug::LoginResponse batchRsp[3];
+    MprpcBatch batch;
+    for (int i = 0; i < 3; ++i)
+    {
+        batchReq[i].set_name("user" + std::to_string(i));
+        batchReq[i].set_pwd("123456");
+        batch.Add(login, nullptr, &batchReq[i], &batchRsp[i]);
+    }
+    MprpcController controller;
+    channel.CallBatch(&batch, &controller);
+    if (controller.Failed())
+    {
+        std::cout << "rpc batch login error: " << controller.ErrorText() << std::endl;
+    }
+    else
+    {
+        std::cout << "rpc batch login response success" << std::endl;
+    }
+
+    // 异步调用：CallMethod 立即返回，响应到达后在客户端 I/O 线程中执行回调
+    fixbug::LoginResponse asyncRsp;
+    MprpcController asyncController;
+    std::promise<void> finished;
+    stub.Login(&asyncController, &request, &asyncRsp,
+               google::protobuf::NewCallback(&OnLoginDone, &asyncRsp, &finished));
+    finished.get_future().wait();
+    if (asyncController.Failed())
+    {
+        std::cout << "rpc async login error: " << asyncController.ErrorText() << std::endl;
+    }
     return 0;
 }
\ No newline at end of file
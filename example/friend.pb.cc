@@ -105,20 +105,24 @@ static const ::_pb::Message* const file_default_instances[] = {
 };
 
 const char descriptor_table_protodef_friend_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
-  "\n\014friend.proto\022\006fixbug\"-\n\nResultCode\022\017\n\007"
-  "errcode\030\001 \001(\005\022\016\n\006errmsg\030\002 \001(\014\"\'\n\025GetFrie"
-  "ndsListRequest\022\016\n\006userid\030\001 \001(\r\"M\n\026GetFri"
-  "endsListResponse\022\"\n\006result\030\001 \001(\0132\022.fixbu"
-  "g.ResultCode\022\017\n\007friends\030\002 \003(\0142b\n\020FriendS"
-  "erviceRpc\022N\n\rGetFriendList\022\035.fixbug.GetF"
-  "riendsListRequest\032\036.fixbug.GetFriendsLis"
-  "tResponseB\003\200\001\001b\006proto3"
+  "\n\014friend.proto\022\006fixbug\032\022mprpcoptions.pro"
+  "to\"-\n\nResultCode\022\017\n\007errcode\030\001 \001(\005\022\016\n\006err"
+  "msg\030\002 \001(\014\"\'\n\025GetFriendsListRequest\022\016\n\006us"
+  "erid\030\001 \001(\r\"M\n\026GetFriendsListResponse\022\"\n\006"
+  "result\030\001 \001(\0132\022.fixbug.ResultCode\022\017\n\007frie"
+  "nds\030\002 \003(\0142h\n\020FriendServiceRpc\022T\n\rGetFrie"
+  "ndList\022\035.fixbug.GetFriendsListRequest\032\036."
+  "fixbug.GetFriendsListResponse\"\004\210\265\030\001B\003\200\001\001"
+  "b\006proto3"
   ;
+static const ::_pbi::DescriptorTable* const descriptor_table_friend_2eproto_deps[1] = {
+  &::descriptor_table_mprpcoptions_2eproto,
+};
 static ::_pbi::once_flag descriptor_table_friend_2eproto_once;
 const ::_pbi::DescriptorTable descriptor_table_friend_2eproto = {
-    false, false, 302, descriptor_table_protodef_friend_2eproto,
+    false, false, 328, descriptor_table_protodef_friend_2eproto,
     "friend.proto",
-    &descriptor_table_friend_2eproto_once, nullptr, 0, 3,
+    &descriptor_table_friend_2eproto_once, descriptor_table_friend_2eproto_deps, 1, 3,
     schemas, file_default_instances, TableStruct_friend_2eproto::offsets,
     file_level_metadata_friend_2eproto, file_level_enum_descriptors_friend_2eproto,
     file_level_service_descriptors_friend_2eproto,
@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @brief 一个服务端地址的熔断器：统计错误率和耗时的指数移动平均，服务端不健康时暂时摘除
+ *
+ * 错误率超过配置项 rpcbreakererrorrate，或连续失败多次时摘除；摘除时长从 rpcbreakerbasems 开始，
+ * 连续被摘除时加倍，最长 rpcbreakermaxms。摘除期满后恢复流量，恢复后的第一次调用仍失败则立即再次摘除，
+ * 成功则退避时长在积累足够的健康样本后清零。
+ */
+class CircuitBreaker
+{
+public:
+    // 记录一次调用：failed 表示说明服务端不健康的失败（传输错误、超时、过载），latency_us 为耗时
+    void Record(bool failed, int64_t latency_us);
+    // 没有被摘除，或摘除期已满
+    bool Available() const;
+    // 成功调用耗时的指数移动平均（微秒），样本不足时返回 -1
+    int64_t LatencyEwma() const { return m_latencyEwma.load(std::memory_order_relaxed); }
+    // 主动摘除（如耗时明显高于同一方法的其他服务端），已被摘除时不重复计数
+    void Eject();
+
+private:
+    std::mutex m_mutex;
+    double m_errorRate = 0;       // 错误率的指数移动平均
+    double m_latency = 0;         // 耗时的指数移动平均（微秒）
+    int m_samples = 0;            // 上次摘除以来的样本数
+    int m_consecutiveFailures = 0;
+    int m_ejections = 0;          // 连续被摘除的次数，决定下次摘除的时长
+    bool m_recovering = false;    // 摘除期满后尚未有调用结果
+    std::atomic<int64_t> m_latencyEwma{-1};
+    std::atomic<int64_t> m_ejectedUntilMs{0}; // 摘除到期的时间，steady_clock 的毫秒数
+
+    void EjectLocked();
+};
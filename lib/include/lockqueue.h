@@ -8,12 +8,29 @@ template <typename T>
 class LockQueue
 {
 public:
+    // maxSize 为 0 表示不限长度
+    explicit LockQueue(size_t maxSize = 0) : m_maxSize(maxSize) {}
+
     void Push(const T &data)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
         m_queue.push(data);
         m_condvariable.notify_one();
     }
+
+    // 有界入队：队列已满时不阻塞，直接返回 false
+    bool TryPush(const T &data)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_maxSize != 0 && m_queue.size() >= m_maxSize)
+        {
+            return false;
+        }
+        m_queue.push(data);
+        m_condvariable.notify_one();
+        return true;
+    }
+
     T Pop()
     {
         std::unique_lock<std::mutex> lock(m_mutex);
@@ -21,12 +38,13 @@ public:
         {
             m_condvariable.wait(lock);
         }
-        T data = m_queue.front();
+        T data = std::move(m_queue.front());
         m_queue.pop();
         return data;
     }
 
 private:
+    size_t m_maxSize;
     std::queue<T> m_queue;
     std::mutex m_mutex;
     std::condition_variable m_condvariable;
@@ -1,6 +1,10 @@
 #pragma once
 #include <google/protobuf/service.h>
+#include <chrono>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <vector>
 class MprpcController : public google::protobuf::RpcController
 {
 public:
@@ -9,12 +13,36 @@ public:
     bool Failed() const;
     std::string ErrorText() const;
     void SetFailed(const std::string &reason);
-    // 目前未实现具体的功能
+    // 取消，可以在任意线程调用。客户端：中止正在进行的调用，并通知服务端取消；
+    // 服务端：由框架在收到取消帧或连接断开时调用，触发 NotifyOnCancel 注册的回调
     void StartCancel();
     bool IsCanceled() const;
+    // 服务端：注册取消回调，取消时执行；调用未被取消时在调用结束后执行，总是恰好执行一次
     void NotifyOnCancel(google::protobuf::Closure *callback);
 
+    // 框架内部使用：客户端设置中止当前调用的方式，传空清除；已被取消时返回 false。
+    // 处理函数在持锁状态下执行，清除返回后保证它不在执行中
+    bool SetCancelHandler(std::function<void()> handler);
+    // 框架内部使用：服务端调用结束，执行尚未触发的 NotifyOnCancel 回调
+    void RunCancelCallbacks();
+
+    // 设置调用的超时时间，从现在开始计时；客户端超时后调用失败，剩余时间随请求发给服务端
+    void SetTimeout(int64_t timeout_ms);
+    void SetDeadline(std::chrono::steady_clock::time_point deadline);
+    bool HasDeadline() const;
+    std::chrono::steady_clock::time_point Deadline() const;
+    // 距截止时间的剩余毫秒数，已超时返回 0；没有截止时间时无意义
+    int64_t RemainingMs() const;
+    bool DeadlineExceeded() const;
+
 private:
     bool m_failed;         // RPC方法执行过程中的状态
     std::string m_errText; // RPC方法执行过程中的错误信息
+    bool m_hasDeadline;    // 是否设置了截止时间
+    std::chrono::steady_clock::time_point m_deadline;
+
+    mutable std::recursive_mutex m_cancelMutex; // 取消处理中可能再次访问 controller
+    bool m_canceled;
+    std::vector<google::protobuf::Closure *> m_cancelCallbacks;
+    std::function<void()> m_cancelHandler;
 };
@@ -0,0 +1,76 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/EventLoopThread.h>
+#include <muduo/net/TcpClient.h>
+#include <muduo/net/TcpConnection.h>
+#include "rpcheader.pb.h"
+
+// 异步 RPC 客户端：进程内共享一个 muduo EventLoop 线程，
+// 每个服务端地址一条长连接，连接上可以同时有多个未完成的请求，按 request_id 匹配响应
+class RpcClient
+{
+public:
+    // 响应回调，在客户端 I/O 线程中执行。
+    // error 为空表示收到了响应帧，rspHeader/payload 为服务端返回的头部和数据；否则为传输错误
+    using ResponseCallback = std::function<void(const std::string &error, const mprpc::RpcHeader &rspHeader,
+                                                const char *payload, size_t payload_size)>;
+
+    static RpcClient &getInstance();
+
+    // 把一帧请求（request_id 已写在帧中）交给 I/O 线程发送，立即返回。
+    // timeout_ms 大于 0 时启动定时器，超时仍未收到响应则以 "deadline exceeded" 回调，之后到达的响应被丢弃
+    void Send(const std::string &host, uint64_t request_id, const std::string &frame, ResponseCallback cb,
+              int64_t timeout_ms = 0);
+    // 放弃一个未完成的请求：从未完成表中移除，已发出的请求通知服务端取消，之后到达的响应被丢弃。
+    // error 非空时以 error 回调，否则不再回调；总是在 I/O 线程中异步执行
+    void Cancel(const std::string &host, uint64_t request_id, const std::string &error = "");
+    // 在客户端 I/O 线程中延迟执行
+    void RunAfter(int64_t delay_ms, std::function<void()> cb);
+
+private:
+    // 一个未完成的请求
+    struct PendingCall
+    {
+        ResponseCallback m_cb;
+        bool m_hasTimer = false;
+        muduo::net::TimerId m_timer; // 超时定时器，完成时取消
+    };
+
+    // 到一个服务端地址的连接及其上未完成的请求，只在 I/O 线程中访问
+    struct Session
+    {
+        std::string m_host;                                        // ip:port 或 unix:/path
+        std::unique_ptr<muduo::net::TcpClient> m_client;           // 最近一次建连使用的客户端，Unix 域套接字地址时为空
+        muduo::net::TcpConnectionPtr m_conn;                       // 已连接时非空
+        bool m_connecting = false;                                 // 正在建立连接
+        uint64_t m_connectSeq = 0;                                 // 第几次建连，用于识别过期的超时定时器
+        std::vector<std::pair<uint64_t, std::string>> m_waiting;   // 连接建立前待发送的帧
+        std::unordered_map<uint64_t, PendingCall> m_pending;       // request_id -> 未完成的请求
+    };
+
+    muduo::net::EventLoopThread m_loopThread;
+    muduo::net::EventLoop *m_loop;
+    std::unordered_map<std::string, std::unique_ptr<Session>> m_sessions; // 只在 I/O 线程中访问
+
+    RpcClient();
+    RpcClient(const RpcClient &) = delete;
+    RpcClient(RpcClient &&) = delete;
+
+    void SendInLoop(const std::string &host, uint64_t request_id, const std::string &frame, const ResponseCallback &cb,
+                    int64_t timeout_ms);
+    void OnTimeout(Session *session, uint64_t request_id);
+    bool RemovePending(Session *session, uint64_t request_id, ResponseCallback *cb);
+    void SendCancelFrame(const muduo::net::TcpConnectionPtr &conn, uint64_t request_id);
+    Session *GetSession(const std::string &host);
+    void Connect(Session *session);
+    void ResetClient(Session *session, uint64_t seq);
+    void ConnectUnix(Session *session);
+    void OnConnection(Session *session, const muduo::net::TcpConnectionPtr &conn);
+    void OnMessage(Session *session, const muduo::net::TcpConnectionPtr &conn, muduo::net::Buffer *buffer);
+    void FailAll(Session *session, const std::string &error);
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "circuitbreaker.h"
+#include "lockqueue.h"
+#include "zookeeperutil.h"
+
+// 服务端地址的运行时状态，进程内每个地址一份，所有 channel 共享
+struct EndpointState
+{
+    std::atomic<int> m_outstanding{0}; // 已发出、尚未完成的请求数
+    CircuitBreaker m_breaker;          // 健康统计，不健康时暂时不再选择该地址
+};
+
+// 方法的一个服务端节点，对应 ZooKeeper 中的一个子节点，数据格式为 ip:port[;weight=N][;unix=/path;host=主机名]
+struct ServiceEndpoint
+{
+    std::string m_host;               // ip:port，标识服务端
+    std::string m_address;            // 实际连接的地址：服务端在本机且提供 Unix 域套接字时为 unix:/path，否则同 m_host
+    int m_weight = 1;                 // 负载均衡权重
+    EndpointState *m_state = nullptr; // 该地址的运行时状态，不会释放
+};
+
+// 方法的服务端列表快照，刷新时整体替换，持有者读取期间不会被修改
+using EndpointList = std::shared_ptr<const std::vector<ServiceEndpoint>>;
+
+// 进程级的服务发现缓存，所有 channel 共享
+// 方法节点第一次查询时从 ZooKeeper 读取服务端列表并注册监听，之后直接从内存返回；
+// 服务端上下线时由监听触发后台刷新，调用路径上不再访问 ZooKeeper
+class ServiceDiscovery
+{
+public:
+    static ServiceDiscovery &getInstance();
+
+    // 查询方法节点（如 /UserServiceRpc/Login）下的服务端列表，没有服务端时返回空指针
+    EndpointList Lookup(const std::string &path);
+
+    // 获取地址对应的运行时状态，不存在时创建
+    EndpointState *GetEndpointState(const std::string &host);
+
+private:
+    std::mutex m_zkMutex;                                   // 保护 m_zkClient
+    ZkClient m_zkClient;                                    // 进程内唯一的 ZooKeeper 会话
+    std::mutex m_cacheMutex;                                // 保护 m_cache
+    std::unordered_map<std::string, EndpointList> m_cache;  // 方法节点路径 -> 服务端列表
+    std::mutex m_stateMutex;                                // 保护 m_states
+    std::unordered_map<std::string, std::unique_ptr<EndpointState>> m_states;
+    LockQueue<std::string> m_refreshQueue;                  // 待刷新的节点路径，空串表示会话过期
+    std::thread m_refreshThread;
+
+    ServiceDiscovery();
+    ServiceDiscovery(const ServiceDiscovery &) = delete;
+    ServiceDiscovery(ServiceDiscovery &&) = delete;
+
+    bool Fetch(const std::string &path, EndpointList *endpoints);
+    bool ParseEndpoint(const std::string &data, ServiceEndpoint *endpoint);
+    static bool PreferUnix();
+    void RefreshLoop();
+    static void DataWatcher(zhandle_t *zh, int type, int state, const char *path, void *watcherCtx);
+};
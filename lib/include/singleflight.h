@@ -0,0 +1,42 @@
+#pragma once
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 相同请求合并：同一时刻 key 相同的多个调用只有第一个真正发出，其余等它的结果
+ *
+ * 第一个调用（发起者）结束时把结果交给所有等待者，随后 key 上可以开始新的调用，所以结果不会被复用到之后的调用。
+ * 按 key 的哈希分片加锁，不同 key 的调用互不阻塞。
+ */
+class SingleFlight
+{
+public:
+    // 调用结果：error 为空表示成功，response_str 为序列化后的响应
+    using Callback = std::function<void(const std::string &error, const std::string &response_str)>;
+
+    static SingleFlight &getInstance();
+
+    // key 上已有调用在进行时登记 cb 并返回 false；否则成为发起者返回 true（不登记 cb），之后必须调用 Finish
+    bool Join(const std::string &key, const Callback &cb);
+    // 发起者的调用结束，在当前线程中依次回调所有等待者
+    void Finish(const std::string &key, const std::string &error, const std::string &response_str);
+
+private:
+    static const size_t kShardCount = 16;
+
+    struct Shard
+    {
+        std::mutex m_mutex;
+        std::unordered_map<std::string, std::vector<Callback>> m_flights; // key -> 等待者
+    };
+    Shard m_shards[kShardCount];
+
+    SingleFlight() = default;
+    SingleFlight(const SingleFlight &) = delete;
+    SingleFlight(SingleFlight &&) = delete;
+
+    Shard &ShardFor(const std::string &key);
+};
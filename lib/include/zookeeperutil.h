@@ -2,6 +2,7 @@
 #include <semaphore.h>
 #include <zookeeper/zookeeper.h>
 #include <string>
+#include <vector>
 
 class ZkClient
 {
@@ -11,8 +12,16 @@ public:
 
     void Start();
     void Create(const char *path, const char *data, int datalen, int state = 0);
+    // 读取节点数据，出错或数据不完整时返回空串
     std::string GetData(const char *path);
+    // 读取节点数据并注册一次性监听，节点变化或删除时 ZooKeeper 回调 watcher；节点不存在或出错返回 false
+    // 注意：watcher 在 ZooKeeper 的回调线程中执行，其中不能再调用同步接口，否则会死锁
+    bool GetData(const char *path, watcher_fn watcher, void *watcherCtx, std::string *data);
+    // 读取子节点列表并注册一次性监听，子节点增减时回调 watcher；节点不存在或出错返回 false
+    bool GetChildren(const char *path, watcher_fn watcher, void *watcherCtx, std::vector<std::string> *children);
 
 private:
     zhandle_t *m_zhandle;
+
+    bool ReadData(const char *path, watcher_fn watcher, void *watcherCtx, std::string *data);
 };
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "circuitbreaker.h"
+#include "mprpcapplication.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// 指数移动平均中新样本的权重
+static const double kAlpha = 0.1;
+// 积累到这么多样本后才按错误率判断、才公布耗时
+static const int kMinSamples = 10;
+// 连续失败这么多次立即摘除，不等错误率
+static const int kMaxConsecutiveFailures = 5;
+
+// 熔断配置，进程内读取一次
+struct BreakerConfig
+{
+    double m_errorRate;
+    int64_t m_baseMs;
+    int64_t m_maxMs;
+};
+
+static const BreakerConfig &Config()
+{
+    static BreakerConfig config = []()
+    {
+        MprpcConfig &conf = MprpcApplication::getInstance().GetConfig();
+        std::string errorRate = conf.Load("rpcbreakererrorrate");
+        std::string baseMs = conf.Load("rpcbreakerbasems");
+        std::string maxMs = conf.Load("rpcbreakermaxms");
+        BreakerConfig c;
+        c.m_errorRate = errorRate.empty() ? 0.5 : atof(errorRate.c_str());
+        c.m_baseMs = baseMs.empty() ? 1000 : atoll(baseMs.c_str());
+        c.m_maxMs = maxMs.empty() ? 30000 : atoll(maxMs.c_str());
+        return c;
+    }();
+    return config;
+}
+
+static int64_t NowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void CircuitBreaker::Record(bool failed, int64_t latency_us)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_recovering)
+    {
+        m_recovering = false;
+        if (failed)
+        {
+            EjectLocked();
+            return;
+        }
+    }
+
+    m_errorRate = m_errorRate * (1 - kAlpha) + (failed ? kAlpha : 0);
+    m_consecutiveFailures = failed ? m_consecutiveFailures + 1 : 0;
+    if (!failed)
+    {
+        m_latency = m_latency == 0 ? latency_us : m_latency * (1 - kAlpha) + latency_us * kAlpha;
+    }
+    m_samples++;
+
+    if (m_consecutiveFailures >= kMaxConsecutiveFailures ||
+        (m_samples >= kMinSamples && m_errorRate > Config().m_errorRate))
+    {
+        EjectLocked();
+        return;
+    }
+    if (m_samples >= kMinSamples)
+    {
+        m_ejections = 0; // 已恢复健康，下次摘除重新从最短时长开始
+        if (m_latency > 0)
+            m_latencyEwma.store(std::llround(m_latency), std::memory_order_relaxed);
+    }
+}
+
+bool CircuitBreaker::Available() const
+{
+    return NowMs() >= m_ejectedUntilMs.load(std::memory_order_relaxed);
+}
+
+void CircuitBreaker::Eject()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (Available())
+    {
+        EjectLocked();
+    }
+}
+
+// 摘除并清空统计：恢复后按新的样本重新判断
+void CircuitBreaker::EjectLocked()
+{
+    const BreakerConfig &config = Config();
+    int shift = std::min(m_ejections, 16);
+    int64_t duration = std::min(config.m_baseMs << shift, config.m_maxMs);
+    m_ejections++;
+    m_ejectedUntilMs.store(NowMs() + duration, std::memory_order_relaxed);
+    m_recovering = true;
+    m_errorRate = 0;
+    m_latency = 0;
+    m_samples = 0;
+    m_consecutiveFailures = 0;
+    m_latencyEwma.store(-1, std::memory_order_relaxed);
+}
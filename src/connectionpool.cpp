@@ -0,0 +1,162 @@
+#include "connectionpool.h"
+#include "mprpcapplication.h"
+#include "rpcaddress.h"
+#include "rpcsocket.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// 未配置时的默认值
+static const size_t kDefaultMaxIdle = 8;
+static const int kDefaultMaxActive = 64;
+static const int kDefaultIdleTimeoutMs = 60 * 1000;
+static const int kDefaultAcquireTimeoutMs = 1000;
+
+// 读取整数配置，未配置时返回默认值
+static long LoadConfigInt(const std::string &key, long default_value)
+{
+    std::string value = MprpcApplication::GetConfig().Load(key);
+    return value.empty() ? default_value : atol(value.c_str());
+}
+
+ConnectionPool::ConnectionPool()
+    : m_maxIdle(LoadConfigInt("rpcpoolmaxidle", kDefaultMaxIdle)),
+      m_maxActive(LoadConfigInt("rpcpoolmaxactive", kDefaultMaxActive)),
+      m_idleTimeout(LoadConfigInt("rpcpoolidletimeout", kDefaultIdleTimeoutMs)),
+      m_acquireTimeout(LoadConfigInt("rpcpoolacquiretimeout", kDefaultAcquireTimeoutMs))
+{
+}
+
+ConnectionPool &ConnectionPool::getInstance()
+{
+    static ConnectionPool pool;
+    return pool;
+}
+
+/**
+ * @brief 借出连接
+ *
+ * 优先复用最近归还的空闲连接（最可能仍然可用），空闲太久或健康检查失败的直接关闭；
+ * 没有空闲连接且未达到借出上限时新建连接，建连过程不持有锁。
+ */
+int ConnectionPool::Acquire(const std::string &host, Clock::time_point deadline, bool *reused, bool *local,
+                            std::string *errtxt)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    std::unique_ptr<Endpoint> &slot = m_endpoints[host];
+    if (!slot)
+    {
+        slot.reset(new Endpoint);
+    }
+    Endpoint &endpoint = *slot;
+
+    // 等待归还的时间不超过 rpcpoolacquiretimeout，也不超过调用的截止时间
+    Clock::time_point wait_deadline = std::min(Clock::now() + m_acquireTimeout, deadline);
+    while (true)
+    {
+        while (!endpoint.m_idle.empty())
+        {
+            IdleConnection conn = endpoint.m_idle.back();
+            endpoint.m_idle.pop_back();
+            if (Clock::now() - conn.m_lastUsed > m_idleTimeout || !IsHealthy(conn.m_fd))
+            {
+                close(conn.m_fd);
+                continue;
+            }
+            ++endpoint.m_active;
+            *reused = true;
+            return conn.m_fd;
+        }
+
+        if (m_maxActive <= 0 || endpoint.m_active < m_maxActive)
+        {
+            break;
+        }
+        if (endpoint.m_cond.wait_until(lock, wait_deadline) == std::cv_status::timeout)
+        {
+            *local = true;
+            *errtxt = wait_deadline == deadline ? "deadline exceeded" : "too many active connections to " + host;
+            return -1;
+        }
+    }
+
+    ++endpoint.m_active; // 先占位再建连
+    lock.unlock();
+
+    *reused = false;
+    int fd = Connect(host, deadline, local, errtxt);
+    if (fd == -1)
+    {
+        lock.lock();
+        --endpoint.m_active;
+        endpoint.m_cond.notify_one();
+    }
+    return fd;
+}
+
+void ConnectionPool::Release(const std::string &host, int fd, bool broken)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Endpoint &endpoint = *m_endpoints[host];
+    --endpoint.m_active;
+    if (broken || endpoint.m_idle.size() >= m_maxIdle)
+    {
+        close(fd);
+    }
+    else
+    {
+        endpoint.m_idle.push_back({fd, Clock::now()});
+    }
+    endpoint.m_cond.notify_one();
+}
+
+/**
+ * @brief 空闲连接的健康检查
+ *
+ * 空闲连接上不应有任何可读事件：可读说明对端已关闭（读到 EOF）或残留了不属于任何调用的数据，
+ * 出错/挂断同样不可用。poll 超时为 0，不会阻塞。
+ */
+bool ConnectionPool::IsHealthy(int fd)
+{
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN | POLLRDHUP;
+    pfd.revents = 0;
+    int ret = poll(&pfd, 1, 0);
+    return ret == 0;
+}
+
+// 建立到 host(ip:port 或 unix:/path) 的连接，失败返回 -1 并设置错误信息。
+// 与短连接相同，有截止时间时以非阻塞方式连接、等待到截止时间；连上后恢复阻塞模式，池中的连接读写前自行 poll
+int ConnectionPool::Connect(const std::string &host, Clock::time_point deadline, bool *local, std::string *errtxt)
+{
+    struct sockaddr_storage server_addr;
+    socklen_t addr_len = ResolveRpcAddress(host, &server_addr);
+    if (addr_len == 0)
+    {
+        *local = true;
+        *errtxt = "invalid provider address: " + host;
+        return -1;
+    }
+
+    int clientfd = socket(server_addr.ss_family, SOCK_STREAM, 0);
+    if (clientfd == -1)
+    {
+        *local = true;
+        *errtxt = "create socket error! errno: " + std::to_string(errno);
+        return -1;
+    }
+
+    if (!ConnectWithDeadline(clientfd, (struct sockaddr *)&server_addr, addr_len, deadline))
+    {
+        *local = false;
+        *errtxt = errno == ETIMEDOUT ? "deadline exceeded" : "connect socket error! errno: " + std::to_string(errno);
+        close(clientfd);
+        return -1;
+    }
+    fcntl(clientfd, F_SETFL, fcntl(clientfd, F_GETFL) & ~O_NONBLOCK);
+    return clientfd;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// 进程级的客户端连接池，按服务端地址 ip:port 分组
+// 调用方独占地借出一条连接，用完归还；空闲连接在借出前做健康检查
+class ConnectionPool
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static ConnectionPool &getInstance();
+
+    // 借出一条到 host 的连接，没有可用的空闲连接时新建；
+    // 该地址借出的连接数达到上限时等待归还，超时返回 -1。reused 表示是否为复用的连接。
+    // deadline 为调用的截止时间（kNoDeadline 表示没有），等待归还和新建连接都不超过它。
+    // 失败时设置 local：原因在本地（借出数达到上限、创建套接字失败等）为 true，连接服务端失败为 false
+    int Acquire(const std::string &host, Clock::time_point deadline, bool *reused, bool *local, std::string *errtxt);
+    // 归还连接；broken 为 true 表示连接状态未知（读写出错、响应未读完），直接关闭
+    void Release(const std::string &host, int fd, bool broken);
+
+private:
+    struct IdleConnection
+    {
+        int m_fd;
+        Clock::time_point m_lastUsed;
+    };
+
+    struct Endpoint
+    {
+        std::deque<IdleConnection> m_idle; // 空闲连接，尾部是最近归还的
+        int m_active = 0;                  // 已借出和正在建立的连接数
+        std::condition_variable m_cond;    // 等待借出数低于上限
+    };
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, std::unique_ptr<Endpoint>> m_endpoints;
+
+    size_t m_maxIdle;                           // 每个地址最多保留的空闲连接数
+    int m_maxActive;                            // 每个地址最多同时借出的连接数，0 表示不限
+    std::chrono::milliseconds m_idleTimeout;    // 空闲超过该时长的连接不再复用
+    std::chrono::milliseconds m_acquireTimeout; // 等待借出的最长时间
+
+    ConnectionPool();
+    ConnectionPool(const ConnectionPool &) = delete;
+    ConnectionPool(ConnectionPool &&) = delete;
+
+    static bool IsHealthy(int fd);
+    static int Connect(const std::string &host, Clock::time_point deadline, bool *local, std::string *errtxt);
+};
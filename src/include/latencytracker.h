@@ -0,0 +1,27 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 记录一个方法最近的调用耗时，估算指定分位数，作为对冲请求的发送延迟
+class LatencyTracker
+{
+public:
+    // 获取方法的耗时统计，不存在时创建，进程内每个方法一份
+    static LatencyTracker *ForMethod(const std::string &full_name);
+
+    void Record(int64_t latency_us);
+    // 最近耗时的分位数（微秒），样本不足时返回 -1
+    int64_t Percentile() const { return m_percentile.load(std::memory_order_relaxed); }
+
+private:
+    static const size_t kWindowSize = 256;  // 保留最近的样本数
+    static const size_t kRecomputeEvery = 32; // 每新增这么多样本重新计算一次分位数
+
+    std::mutex m_mutex;
+    std::vector<int64_t> m_samples; // 环形缓冲区
+    size_t m_next = 0;              // 下一个写入位置
+    size_t m_sinceRecompute = 0;
+    std::atomic<int64_t> m_percentile{-1};
+};
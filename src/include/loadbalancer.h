@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <string>
+#include <vector>
+#include "servicediscovery.h"
+
+// 负载均衡策略：从方法的多个服务端中选出一个
+// 可以继承实现自定义策略，通过 MprpcChannel 的构造参数传入
+class LoadBalancer
+{
+public:
+    virtual ~LoadBalancer() = default;
+
+    // 从 endpoints（非空）中选出一个，返回下标，不小于 endpoints.size() 表示没有可选的服务端；
+    // 可能被多个线程同时调用
+    virtual size_t Select(const std::vector<ServiceEndpoint> &endpoints) = 0;
+
+    // 按名字创建内置策略：roundrobin、weighted、leastrequests、p2c，未知名字返回空指针
+    static LoadBalancer *Create(const std::string &name);
+    // 进程默认策略，由配置项 rpcloadbalance 指定，未配置时为 roundrobin
+    static LoadBalancer *Default();
+};
+
+// 轮询
+class RoundRobinLoadBalancer : public LoadBalancer
+{
+public:
+    size_t Select(const std::vector<ServiceEndpoint> &endpoints) override;
+
+private:
+    std::atomic<size_t> m_next{0};
+};
+
+// 按权重随机选择，被选中的概率与 weight 成正比
+class WeightedLoadBalancer : public LoadBalancer
+{
+public:
+    size_t Select(const std::vector<ServiceEndpoint> &endpoints) override;
+};
+
+// 选未完成请求数最少的服务端，数量相同时从随机位置开始取第一个，避免总是压到同一台
+class LeastRequestsLoadBalancer : public LoadBalancer
+{
+public:
+    size_t Select(const std::vector<ServiceEndpoint> &endpoints) override;
+};
+
+// 随机取两个服务端，选未完成请求数较少的一个，开销为常数，效果接近最少请求数
+class PowerOfTwoChoicesLoadBalancer : public LoadBalancer
+{
+public:
+    size_t Select(const std::vector<ServiceEndpoint> &endpoints) override;
+};
+
+// 固定选择地址为 host 的服务端，它不在列表中时不选择任何服务端
+class PinnedLoadBalancer : public LoadBalancer
+{
+public:
+    explicit PinnedLoadBalancer(const std::string &host) : m_host(host) {}
+    size_t Select(const std::vector<ServiceEndpoint> &endpoints) override;
+
+private:
+    std::string m_host;
+};
@@ -2,11 +2,106 @@
 #include <google/protobuf/service.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/message.h>
+#include "rpcheader.pb.h"
+#include "loadbalancer.h"
+#include "rpcclient.h"
+#include "responsecache.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+// 批量调用：多个请求放在一帧中发送，服务端执行完后一次性返回
+// 所有方法必须由同一个服务端提供
+class MprpcBatch
+{
+public:
+    // controller 可以为空，为空时该项的错误只能通过 CallBatch 的 controller 得知
+    void Add(const google::protobuf::MethodDescriptor *method,
+             google::protobuf::RpcController *controller,
+             const google::protobuf::Message *request,
+             google::protobuf::Message *response);
+    size_t Size() const { return m_items.size(); }
+    void Clear() { m_items.clear(); }
+
+private:
+    friend class MprpcChannel;
+
+    struct Item
+    {
+        const google::protobuf::MethodDescriptor *m_method;
+        google::protobuf::RpcController *m_controller;
+        const google::protobuf::Message *m_request;
+        google::protobuf::Message *m_response;
+    };
+    std::vector<Item> m_items;
+};
 
 class MprpcChannel : public google::protobuf::RpcChannel
 {
 public:
+    // 同步调用的连接方式
+    enum ConnectionMode
+    {
+        kShortConnection, // 每次调用新建连接，收到响应后关闭
+        kPooled,          // 从进程级连接池独占借出长连接，一条连接上同一时刻只有一个请求
+        kPipelined,       // 所有调用共用到每个服务端的一条长连接，请求连续发出，响应可以乱序返回
+    };
+
+    // keepAlive 为 true 时使用 kPooled，否则使用 kShortConnection。
+    // loadBalancer 为方法有多个服务端时的选择策略，为空时使用配置的默认策略；由调用方管理生命周期
+    explicit MprpcChannel(bool keepAlive = false, LoadBalancer *loadBalancer = nullptr);
+    explicit MprpcChannel(ConnectionMode mode, LoadBalancer *loadBalancer = nullptr);
+
+    // done 为空时同步调用，返回时 response 已就绪；
+    // done 非空时异步调用，立即返回，响应解析完成后在客户端 I/O 线程中执行 done->Run()。
+    // controller 不能为空，错误、截止时间和取消都经由它传递
     void CallMethod(const google::protobuf::MethodDescriptor *method,
                     google::protobuf::RpcController *controller, const google::protobuf::Message *request,
                     google::protobuf::Message *response, google::protobuf::Closure *done);
-};
\ No newline at end of file
+
+    // 发送批量调用，整批的传输错误设置到 controller，各项的错误设置到各自的 controller
+    void CallBatch(MprpcBatch *batch, google::protobuf::RpcController *controller);
+
+    // 是否合并同一时刻的相同请求（幂等方法，且配置项 rpcsingleflight 未关闭），默认合并
+    void SetSingleFlight(bool enabled) { m_singleFlight = enabled; }
+    // 是否使用响应缓存（幂等方法，且为该方法配置了 rpccachettlms），默认使用；
+    // 每次调用都必须真正发出时关闭，关闭后既不读取也不写入缓存
+    void SetResponseCache(bool enabled) { m_responseCache = enabled; }
+
+private:
+    // 经由客户端 I/O 线程发送一次调用，完成时回调
+    using SendFunction = std::function<void(RpcClient::ResponseCallback)>;
+
+    ConnectionMode m_mode;
+    LoadBalancer *m_loadBalancer;
+    bool m_singleFlight;
+    bool m_responseCache;
+
+    // 合并调用中发起者的状态，调用结束时把结果交给等待者
+    struct FlightCall
+    {
+        std::string m_key;
+        google::protobuf::RpcController *m_controller;
+        google::protobuf::Message *m_response;
+        google::protobuf::Closure *m_done;
+    };
+
+    void Invoke(const google::protobuf::MethodDescriptor *method, google::protobuf::RpcController *controller,
+                const std::string &args_str, ResponseCache *cache, google::protobuf::Message *response,
+                google::protobuf::Closure *done);
+    void CallCoalesced(const google::protobuf::MethodDescriptor *method, google::protobuf::RpcController *controller,
+                       const std::string &args_str, ResponseCache *cache, google::protobuf::Message *response,
+                       google::protobuf::Closure *done);
+    static void FinishFlight(FlightCall *call);
+    bool SelectEndpoint(const google::protobuf::MethodDescriptor *method,
+                        google::protobuf::RpcController *controller, ServiceEndpoint *endpoint);
+    bool SelectBackup(const google::protobuf::MethodDescriptor *method, const ServiceEndpoint &primary,
+                      ServiceEndpoint *backup);
+    void CallAsync(const SendFunction &send, google::protobuf::RpcController *controller,
+                   google::protobuf::Message *response, google::protobuf::Closure *done);
+    bool Transact(const std::string &host, uint64_t request_id, const std::string &send_rpc_str,
+                  google::protobuf::RpcController *controller, mprpc::RpcHeader *rspHeader, std::string *response_str,
+                  bool *local);
+    bool TransactAsync(const SendFunction &send, google::protobuf::RpcController *controller,
+                       mprpc::RpcHeader *rspHeader, std::string *response_str);
+};
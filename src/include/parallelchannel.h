@@ -0,0 +1,85 @@
+#pragma once
+#include <google/protobuf/service.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#include "mprpcchannel.h"
+#include "mprpccontroller.h"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 并行调用：同时发起多个子调用，结果交给合并回调，总耗时约为最慢的子调用而不是各次之和
+ *
+ * 子调用可以是同一个请求发给方法的每个服务端（AddAllProviders），也可以是发给不同服务的不同请求（AddCall）。
+ * 子调用经由客户端 I/O 线程异步发出，各自的响应由框架分配，不需要调用方准备。
+ */
+class ParallelChannel
+{
+public:
+    // 合并回调：子调用 index（添加的顺序）成功时执行，response 为其响应。
+    // 各次回调在客户端 I/O 线程中串行执行，不需要加锁；调用结束后不再回调
+    using Merger = std::function<void(size_t index, const google::protobuf::Message &response)>;
+
+    ParallelChannel() = default;
+
+    // 添加子调用：经 channel 调用 method，channel 和 request 只需在 Call 返回前有效
+    void AddCall(google::protobuf::RpcChannel *channel, const google::protobuf::MethodDescriptor *method,
+                 const google::protobuf::Message *request);
+    // 把同一个请求发给方法当前的每个服务端，返回添加的子调用数；查不到服务端时设置错误信息并返回 0
+    size_t AddAllProviders(const google::protobuf::MethodDescriptor *method, const google::protobuf::Message *request,
+                           google::protobuf::RpcController *controller);
+    size_t Size() const { return m_calls.size(); }
+    void Clear();
+
+    /**
+     * @brief 发起所有子调用
+     *
+     * quorum 个子调用成功即结束（0 表示需要全部成功），其余仍在进行的子调用被取消；
+     * 失败的子调用使成功数不可能达到 quorum 时立即失败。controller 上的截止时间和取消作用于所有子调用。
+     * done 为空时阻塞到结束；否则立即返回，结束后执行 done->Run()。
+     */
+    void Call(google::protobuf::RpcController *controller, const Merger &merger, size_t quorum = 0,
+              google::protobuf::Closure *done = nullptr);
+
+private:
+    struct SubCall
+    {
+        google::protobuf::RpcChannel *m_channel;
+        const google::protobuf::MethodDescriptor *m_method;
+        const google::protobuf::Message *m_request;
+    };
+
+    // 一次 Call 的状态，由各子调用的回调共同持有：取消后的子调用可能在 Call 结束后才回调
+    struct CallState
+    {
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+        Merger m_merger;
+        google::protobuf::RpcController *m_controller;
+        google::protobuf::Closure *m_done;
+        size_t m_quorum;
+        size_t m_succeeded = 0;
+        size_t m_failed = 0;
+        bool m_finished = false;
+        std::string m_firstError;
+        std::vector<std::unique_ptr<MprpcController>> m_controllers;
+        std::vector<std::unique_ptr<google::protobuf::Message>> m_responses;
+        std::vector<bool> m_completed;
+    };
+    using CallStatePtr = std::shared_ptr<CallState>;
+
+    std::vector<SubCall> m_calls;
+    // AddAllProviders 为每个服务端创建的 channel 及其负载均衡策略
+    std::vector<std::unique_ptr<LoadBalancer>> m_balancers;
+    std::vector<std::unique_ptr<MprpcChannel>> m_channels;
+
+    static void OnCallDone(CallStatePtr state, size_t index);
+    static void CancelPending(CallState *state);
+
+    ParallelChannel(const ParallelChannel &) = delete;
+    ParallelChannel &operator=(const ParallelChannel &) = delete;
+};
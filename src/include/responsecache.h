@@ -0,0 +1,53 @@
+#pragma once
+#include <google/protobuf/descriptor.h>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief 客户端响应缓存，每个方法一份，键为序列化后的请求
+ *
+ * 只对标记了 (mprpc.idempotent) 且在配置中设置了有效期的方法启用：
+ *   rpccachettlms.<方法全名>=有效期（毫秒）
+ *   rpccachebytes.<方法全名>=缓存上限（字节，默认 16MB）
+ * 缓存按键的哈希分片，每片一把锁、各自按 LRU 淘汰，不同请求的查找互不阻塞。
+ */
+class ResponseCache
+{
+public:
+    // 方法的缓存，未启用时返回 nullptr
+    static ResponseCache *ForMethod(const google::protobuf::MethodDescriptor *method);
+
+    // 查找未过期的响应，命中时拷贝到 response_str
+    bool Lookup(const std::string &request_str, std::string *response_str);
+    void Insert(const std::string &request_str, const std::string &response_str);
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static const size_t kShardCount = 16;
+
+    struct Entry
+    {
+        std::string m_key;
+        std::string m_value;
+        Clock::time_point m_expire;
+    };
+
+    struct Shard
+    {
+        std::mutex m_mutex;
+        std::list<Entry> m_lru; // 表头为最近使用
+        std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+        size_t m_bytes = 0;
+    };
+
+    std::chrono::milliseconds m_ttl;
+    size_t m_shardBytes; // 每片的容量上限
+    Shard m_shards[kShardCount];
+
+    ResponseCache(int64_t ttl_ms, size_t max_bytes);
+    Shard &ShardFor(const std::string &key);
+    static void Erase(Shard &shard, std::list<Entry>::iterator it);
+};
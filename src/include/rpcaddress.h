@@ -0,0 +1,13 @@
+#pragma once
+#include <string>
+#include <sys/socket.h>
+
+// 客户端的连接地址：ip:port 为 TCP 地址，unix:/path 为同一主机上服务端的 Unix 域套接字
+const char kUnixAddressPrefix[] = "unix:";
+
+// 是否为 Unix 域套接字地址
+bool IsUnixAddress(const std::string &address);
+// 把连接地址解析为 sockaddr，返回地址长度，格式错误时返回 0
+socklen_t ResolveRpcAddress(const std::string &address, struct sockaddr_storage *addr);
+// 本机主机名，服务端注册时发布，客户端据此判断服务端是否在本机
+const std::string &LocalHostName();
@@ -0,0 +1,250 @@
+#pragma once
+// C++20 协程接口：编译器未开启协程支持（如未使用 -std=c++20）时整个文件为空，不影响其余代码
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <google/protobuf/service.h>
+#include "threadpool.h"
+
+// ---------------------------- 执行器 ----------------------------
+// 协程执行器：固定数量的工作线程，RPC 响应到达后协程被投递到这里恢复，不占用客户端 I/O 线程
+class RpcExecutor : public ThreadPool
+{
+public:
+    explicit RpcExecutor(int threadNum = 1) : ThreadPool(threadNum, 0) { Start(); }
+
+    // 投递任务，队列不限长度，总是成功
+    void Post(const Task &task) { TryRun(task); }
+};
+
+// ---------------------------- 协程任务 ----------------------------
+template <typename T>
+class RpcTask;
+
+// 任务结束时转到等待它的协程（对称转移，不增加栈深度）
+struct RpcTaskFinalAwaiter
+{
+    bool await_ready() noexcept { return false; }
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+    {
+        std::coroutine_handle<> continuation = handle.promise().m_continuation;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+    void await_resume() noexcept {}
+};
+
+// 任务的公共部分：记录等待方和未捕获的异常
+class RpcTaskPromiseBase
+{
+public:
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    RpcTaskFinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { m_exception = std::current_exception(); }
+
+    std::coroutine_handle<> m_continuation;
+    std::exception_ptr m_exception;
+};
+
+template <typename T>
+class RpcTaskPromise : public RpcTaskPromiseBase
+{
+public:
+    RpcTask<T> get_return_object();
+    void return_value(T value) { m_value.emplace(std::move(value)); }
+    T Result()
+    {
+        if (m_exception)
+            std::rethrow_exception(m_exception);
+        return std::move(*m_value);
+    }
+
+private:
+    std::optional<T> m_value;
+};
+
+template <>
+class RpcTaskPromise<void> : public RpcTaskPromiseBase
+{
+public:
+    RpcTask<void> get_return_object();
+    void return_void() {}
+    void Result()
+    {
+        if (m_exception)
+            std::rethrow_exception(m_exception);
+    }
+};
+
+/**
+ * @brief 协程任务，返回 T
+ *
+ * 创建后不立即执行：被另一个协程 co_await 时开始，结束后恢复等待方；
+ * 最外层的任务交给 RpcSpawn 在执行器上启动。
+ */
+template <typename T = void>
+class RpcTask
+{
+public:
+    using promise_type = RpcTaskPromise<T>;
+
+    explicit RpcTask(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+    RpcTask(RpcTask &&other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+    RpcTask &operator=(RpcTask &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_handle)
+                m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+    ~RpcTask()
+    {
+        if (m_handle)
+            m_handle.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        m_handle.promise().m_continuation = awaiting;
+        return m_handle;
+    }
+    T await_resume() { return m_handle.promise().Result(); }
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+
+    RpcTask(const RpcTask &) = delete;
+    RpcTask &operator=(const RpcTask &) = delete;
+};
+
+template <typename T>
+RpcTask<T> RpcTaskPromise<T>::get_return_object()
+{
+    return RpcTask<T>(std::coroutine_handle<RpcTaskPromise<T>>::from_promise(*this));
+}
+
+inline RpcTask<void> RpcTaskPromise<void>::get_return_object()
+{
+    return RpcTask<void>(std::coroutine_handle<RpcTaskPromise<void>>::from_promise(*this));
+}
+
+// 立即执行、结束后自行销毁的协程，只供 RpcSpawn 使用
+struct RpcDetachedTask
+{
+    struct promise_type
+    {
+        RpcDetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+template <typename T>
+RpcDetachedTask RpcRunDetached(RpcTask<T> task, std::shared_ptr<std::promise<T>> result)
+{
+    try
+    {
+        if constexpr (std::is_void_v<T>)
+        {
+            co_await task;
+            result->set_value();
+        }
+        else
+        {
+            result->set_value(co_await task);
+        }
+    }
+    catch (...)
+    {
+        result->set_exception(std::current_exception());
+    }
+}
+
+// 在执行器上启动任务，返回的 future 在任务结束时就绪（任务抛出的异常由 future.get() 重新抛出）
+template <typename T>
+std::future<T> RpcSpawn(RpcExecutor &executor, RpcTask<T> task)
+{
+    std::shared_ptr<std::promise<T>> result = std::make_shared<std::promise<T>>();
+    std::future<T> future = result->get_future();
+    std::shared_ptr<RpcTask<T>> pending = std::make_shared<RpcTask<T>>(std::move(task));
+    executor.Post([pending, result]()
+                  { RpcRunDetached(std::move(*pending), result); });
+    return future;
+}
+
+// ---------------------------- RPC 调用 ----------------------------
+/**
+ * @brief co_await 一次 RPC 调用，挂起协程，响应到达后在执行器上恢复，结果为响应消息
+ *
+ * 通过存根的异步接口（done 非空）发起调用，不占用线程等待；错误和取消照常通过 controller 报告。
+ * 调用在 await_suspend 中同步出错时 done 会立即执行，这时不挂起，直接继续执行协程。
+ */
+template <typename Response>
+class RpcCallAwaiter : public google::protobuf::Closure
+{
+public:
+    using Invoker = std::function<void(Response *, google::protobuf::Closure *)>;
+
+    RpcCallAwaiter(RpcExecutor &executor, Invoker invoker)
+        : m_executor(executor), m_invoker(std::move(invoker)), m_started(false) {}
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        m_handle = handle;
+        m_invoker(&m_response, this);
+        // done 已经执行过则不挂起；否则由之后执行的 done 负责恢复
+        return !m_started.exchange(true);
+    }
+    Response await_resume() { return std::move(m_response); }
+
+    // done：调用结束，在客户端 I/O 线程（或同步出错时在调用方线程）中执行
+    void Run() override
+    {
+        if (m_started.exchange(true))
+        {
+            std::coroutine_handle<> handle = m_handle;
+            m_executor.Post([handle]()
+                            { handle.resume(); });
+        }
+    }
+
+private:
+    RpcExecutor &m_executor;
+    Invoker m_invoker;
+    Response m_response;
+    std::coroutine_handle<> m_handle;
+    std::atomic<bool> m_started; // await_suspend 与 done 谁后到谁负责继续执行协程
+};
+
+/**
+ * @brief 以协程方式调用生成的存根方法
+ *
+ *   fixbug::LoginResponse response =
+ *       co_await RpcCall(executor, stub, &fixbug::UserServiceRpc_Stub::Login, &controller, request);
+ *
+ * request 和 controller 需要在 co_await 结束前有效。
+ */
+template <typename Stub, typename Request, typename Response>
+RpcCallAwaiter<Response> RpcCall(RpcExecutor &executor, Stub &stub,
+                                 void (Stub::*method)(google::protobuf::RpcController *, const Request *,
+                                                      Response *, google::protobuf::Closure *),
+                                 google::protobuf::RpcController *controller, const Request &request)
+{
+    return RpcCallAwaiter<Response>(executor, [&stub, method, controller, &request](Response *response, google::protobuf::Closure *done)
+                                    { (stub.*method)(controller, &request, response, done); });
+}
+#endif
@@ -29,6 +29,7 @@
 #include <google/protobuf/message.h>
 #include <google/protobuf/repeated_field.h>  // IWYU pragma: export
 #include <google/protobuf/extension_set.h>  // IWYU pragma: export
+#include <google/protobuf/generated_enum_reflection.h>
 #include <google/protobuf/unknown_field_set.h>
 // @@protoc_insertion_point(includes)
 #include <google/protobuf/port_def.inc>
@@ -45,15 +46,80 @@ struct TableStruct_rpcheader_2eproto {
 };
 extern const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_rpcheader_2eproto;
 namespace mprpc {
+class RpcBatch;
+struct RpcBatchDefaultTypeInternal;
+extern RpcBatchDefaultTypeInternal _RpcBatch_default_instance_;
+class RpcBatchItem;
+struct RpcBatchItemDefaultTypeInternal;
+extern RpcBatchItemDefaultTypeInternal _RpcBatchItem_default_instance_;
 class RpcHeader;
 struct RpcHeaderDefaultTypeInternal;
 extern RpcHeaderDefaultTypeInternal _RpcHeader_default_instance_;
 }  // namespace mprpc
 PROTOBUF_NAMESPACE_OPEN
+template<> ::mprpc::RpcBatch* Arena::CreateMaybeMessage<::mprpc::RpcBatch>(Arena*);
+template<> ::mprpc::RpcBatchItem* Arena::CreateMaybeMessage<::mprpc::RpcBatchItem>(Arena*);
 template<> ::mprpc::RpcHeader* Arena::CreateMaybeMessage<::mprpc::RpcHeader>(Arena*);
 PROTOBUF_NAMESPACE_CLOSE
 namespace mprpc {
 
+enum RpcErrorCode : int {
+  RPC_OK = 0,
+  RPC_SERVICE_NOT_FOUND = 1,
+  RPC_METHOD_NOT_FOUND = 2,
+  RPC_REQUEST_PARSE_ERROR = 3,
+  RPC_SERVER_BUSY = 4,
+  RPC_CALL_FAILED = 5,
+  RPC_DEADLINE_EXCEEDED = 6,
+  RPC_CANCELED = 7,
+  RpcErrorCode_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  RpcErrorCode_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool RpcErrorCode_IsValid(int value);
+constexpr RpcErrorCode RpcErrorCode_MIN = RPC_OK;
+constexpr RpcErrorCode RpcErrorCode_MAX = RPC_CANCELED;
+constexpr int RpcErrorCode_ARRAYSIZE = RpcErrorCode_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* RpcErrorCode_descriptor();
+template<typename T>
+inline const std::string& RpcErrorCode_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, RpcErrorCode>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function RpcErrorCode_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    RpcErrorCode_descriptor(), enum_t_value);
+}
+inline bool RpcErrorCode_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, RpcErrorCode* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<RpcErrorCode>(
+    RpcErrorCode_descriptor(), name, value);
+}
+enum RpcFrameType : int {
+  RPC_FRAME_SINGLE = 0,
+  RPC_FRAME_BATCH = 1,
+  RPC_FRAME_CANCEL = 2,
+  RpcFrameType_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  RpcFrameType_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool RpcFrameType_IsValid(int value);
+constexpr RpcFrameType RpcFrameType_MIN = RPC_FRAME_SINGLE;
+constexpr RpcFrameType RpcFrameType_MAX = RPC_FRAME_CANCEL;
+constexpr int RpcFrameType_ARRAYSIZE = RpcFrameType_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* RpcFrameType_descriptor();
+template<typename T>
+inline const std::string& RpcFrameType_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, RpcFrameType>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function RpcFrameType_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    RpcFrameType_descriptor(), enum_t_value);
+}
+inline bool RpcFrameType_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, RpcFrameType* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<RpcFrameType>(
+    RpcFrameType_descriptor(), name, value);
+}
 // ===================================================================
 
 class RpcHeader final :
@@ -179,7 +245,13 @@ class RpcHeader final :
   enum : int {
     kServiceNameFieldNumber = 1,
     kMethodNameFieldNumber = 2,
+    kErrorTextFieldNumber = 6,
+    kRequestIdFieldNumber = 4,
     kArgsSizeFieldNumber = 3,
+    kErrorCodeFieldNumber = 5,
+    kMethodIdFieldNumber = 7,
+    kFrameTypeFieldNumber = 8,
+    kTimeoutMsFieldNumber = 9,
   };
   // bytes service_name = 1;
   void clear_service_name();
@@ -209,6 +281,29 @@ class RpcHeader final :
   std::string* _internal_mutable_method_name();
   public:
 
+  // bytes error_text = 6;
+  void clear_error_text();
+  const std::string& error_text() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_error_text(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_error_text();
+  PROTOBUF_NODISCARD std::string* release_error_text();
+  void set_allocated_error_text(std::string* error_text);
+  private:
+  const std::string& _internal_error_text() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_error_text(const std::string& value);
+  std::string* _internal_mutable_error_text();
+  public:
+
+  // uint64 request_id = 4;
+  void clear_request_id();
+  uint64_t request_id() const;
+  void set_request_id(uint64_t value);
+  private:
+  uint64_t _internal_request_id() const;
+  void _internal_set_request_id(uint64_t value);
+  public:
+
   // uint32 args_size = 3;
   void clear_args_size();
   uint32_t args_size() const;
@@ -218,6 +313,42 @@ class RpcHeader final :
   void _internal_set_args_size(uint32_t value);
   public:
 
+  // .mprpc.RpcErrorCode error_code = 5;
+  void clear_error_code();
+  ::mprpc::RpcErrorCode error_code() const;
+  void set_error_code(::mprpc::RpcErrorCode value);
+  private:
+  ::mprpc::RpcErrorCode _internal_error_code() const;
+  void _internal_set_error_code(::mprpc::RpcErrorCode value);
+  public:
+
+  // uint32 method_id = 7;
+  void clear_method_id();
+  uint32_t method_id() const;
+  void set_method_id(uint32_t value);
+  private:
+  uint32_t _internal_method_id() const;
+  void _internal_set_method_id(uint32_t value);
+  public:
+
+  // .mprpc.RpcFrameType frame_type = 8;
+  void clear_frame_type();
+  ::mprpc::RpcFrameType frame_type() const;
+  void set_frame_type(::mprpc::RpcFrameType value);
+  private:
+  ::mprpc::RpcFrameType _internal_frame_type() const;
+  void _internal_set_frame_type(::mprpc::RpcFrameType value);
+  public:
+
+  // uint32 timeout_ms = 9;
+  void clear_timeout_ms();
+  uint32_t timeout_ms() const;
+  void set_timeout_ms(uint32_t value);
+  private:
+  uint32_t _internal_timeout_ms() const;
+  void _internal_set_timeout_ms(uint32_t value);
+  public:
+
   // @@protoc_insertion_point(class_scope:mprpc.RpcHeader)
  private:
   class _Internal;
@@ -228,7 +359,343 @@ class RpcHeader final :
   struct Impl_ {
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr service_name_;
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr method_name_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr error_text_;
+    uint64_t request_id_;
     uint32_t args_size_;
+    int error_code_;
+    uint32_t method_id_;
+    int frame_type_;
+    uint32_t timeout_ms_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_rpcheader_2eproto;
+};
+// -------------------------------------------------------------------
+
+class RpcBatchItem final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:mprpc.RpcBatchItem) */ {
+ public:
+  inline RpcBatchItem() : RpcBatchItem(nullptr) {}
+  ~RpcBatchItem() override;
+  explicit PROTOBUF_CONSTEXPR RpcBatchItem(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  RpcBatchItem(const RpcBatchItem& from);
+  RpcBatchItem(RpcBatchItem&& from) noexcept
+    : RpcBatchItem() {
+    *this = ::std::move(from);
+  }
+
+  inline RpcBatchItem& operator=(const RpcBatchItem& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline RpcBatchItem& operator=(RpcBatchItem&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const RpcBatchItem& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const RpcBatchItem* internal_default_instance() {
+    return reinterpret_cast<const RpcBatchItem*>(
+               &_RpcBatchItem_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    1;
+
+  friend void swap(RpcBatchItem& a, RpcBatchItem& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(RpcBatchItem* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(RpcBatchItem* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  RpcBatchItem* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<RpcBatchItem>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const RpcBatchItem& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const RpcBatchItem& from) {
+    RpcBatchItem::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(RpcBatchItem* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "mprpc.RpcBatchItem";
+  }
+  protected:
+  explicit RpcBatchItem(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kArgsFieldNumber = 2,
+    kHeaderFieldNumber = 1,
+  };
+  // bytes args = 2;
+  void clear_args();
+  const std::string& args() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_args(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_args();
+  PROTOBUF_NODISCARD std::string* release_args();
+  void set_allocated_args(std::string* args);
+  private:
+  const std::string& _internal_args() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_args(const std::string& value);
+  std::string* _internal_mutable_args();
+  public:
+
+  // .mprpc.RpcHeader header = 1;
+  bool has_header() const;
+  private:
+  bool _internal_has_header() const;
+  public:
+  void clear_header();
+  const ::mprpc::RpcHeader& header() const;
+  PROTOBUF_NODISCARD ::mprpc::RpcHeader* release_header();
+  ::mprpc::RpcHeader* mutable_header();
+  void set_allocated_header(::mprpc::RpcHeader* header);
+  private:
+  const ::mprpc::RpcHeader& _internal_header() const;
+  ::mprpc::RpcHeader* _internal_mutable_header();
+  public:
+  void unsafe_arena_set_allocated_header(
+      ::mprpc::RpcHeader* header);
+  ::mprpc::RpcHeader* unsafe_arena_release_header();
+
+  // @@protoc_insertion_point(class_scope:mprpc.RpcBatchItem)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr args_;
+    ::mprpc::RpcHeader* header_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_rpcheader_2eproto;
+};
+// -------------------------------------------------------------------
+
+class RpcBatch final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:mprpc.RpcBatch) */ {
+ public:
+  inline RpcBatch() : RpcBatch(nullptr) {}
+  ~RpcBatch() override;
+  explicit PROTOBUF_CONSTEXPR RpcBatch(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  RpcBatch(const RpcBatch& from);
+  RpcBatch(RpcBatch&& from) noexcept
+    : RpcBatch() {
+    *this = ::std::move(from);
+  }
+
+  inline RpcBatch& operator=(const RpcBatch& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline RpcBatch& operator=(RpcBatch&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const RpcBatch& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const RpcBatch* internal_default_instance() {
+    return reinterpret_cast<const RpcBatch*>(
+               &_RpcBatch_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    2;
+
+  friend void swap(RpcBatch& a, RpcBatch& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(RpcBatch* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(RpcBatch* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  RpcBatch* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<RpcBatch>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const RpcBatch& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const RpcBatch& from) {
+    RpcBatch::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(RpcBatch* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "mprpc.RpcBatch";
+  }
+  protected:
+  explicit RpcBatch(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kItemsFieldNumber = 1,
+  };
+  // repeated .mprpc.RpcBatchItem items = 1;
+  int items_size() const;
+  private:
+  int _internal_items_size() const;
+  public:
+  void clear_items();
+  ::mprpc::RpcBatchItem* mutable_items(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::mprpc::RpcBatchItem >*
+      mutable_items();
+  private:
+  const ::mprpc::RpcBatchItem& _internal_items(int index) const;
+  ::mprpc::RpcBatchItem* _internal_add_items();
+  public:
+  const ::mprpc::RpcBatchItem& items(int index) const;
+  ::mprpc::RpcBatchItem* add_items();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::mprpc::RpcBatchItem >&
+      items() const;
+
+  // @@protoc_insertion_point(class_scope:mprpc.RpcBatch)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::mprpc::RpcBatchItem > items_;
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   };
   union { Impl_ _impl_; };
@@ -365,14 +832,371 @@ inline void RpcHeader::set_args_size(uint32_t value) {
   // @@protoc_insertion_point(field_set:mprpc.RpcHeader.args_size)
 }
 
+// uint64 request_id = 4;
+inline void RpcHeader::clear_request_id() {
+  _impl_.request_id_ = uint64_t{0u};
+}
+inline uint64_t RpcHeader::_internal_request_id() const {
+  return _impl_.request_id_;
+}
+inline uint64_t RpcHeader::request_id() const {
+  // @@protoc_insertion_point(field_get:mprpc.RpcHeader.request_id)
+  return _internal_request_id();
+}
+inline void RpcHeader::_internal_set_request_id(uint64_t value) {
+  
+  _impl_.request_id_ = value;
+}
+inline void RpcHeader::set_request_id(uint64_t value) {
+  _internal_set_request_id(value);
+  // @@protoc_insertion_point(field_set:mprpc.RpcHeader.request_id)
+}
+
+// .mprpc.RpcErrorCode error_code = 5;
+inline void RpcHeader::clear_error_code() {
+  _impl_.error_code_ = 0;
+}
+inline ::mprpc::RpcErrorCode RpcHeader::_internal_error_code() const {
+  return static_cast< ::mprpc::RpcErrorCode >(_impl_.error_code_);
+}
+inline ::mprpc::RpcErrorCode RpcHeader::error_code() const {
+  // @@protoc_insertion_point(field_get:mprpc.RpcHeader.error_code)
+  return _internal_error_code();
+}
+inline void RpcHeader::_internal_set_error_code(::mprpc::RpcErrorCode value) {
+  
+  _impl_.error_code_ = value;
+}
+inline void RpcHeader::set_error_code(::mprpc::RpcErrorCode value) {
+  _internal_set_error_code(value);
+  // @@protoc_insertion_point(field_set:mprpc.RpcHeader.error_code)
+}
+
+// bytes error_text = 6;
+inline void RpcHeader::clear_error_text() {
+  _impl_.error_text_.ClearToEmpty();
+}
+inline const std::string& RpcHeader::error_text() const {
+  // @@protoc_insertion_point(field_get:mprpc.RpcHeader.error_text)
+  return _internal_error_text();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void RpcHeader::set_error_text(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.error_text_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:mprpc.RpcHeader.error_text)
+}
+inline std::string* RpcHeader::mutable_error_text() {
+  std::string* _s = _internal_mutable_error_text();
+  // @@protoc_insertion_point(field_mutable:mprpc.RpcHeader.error_text)
+  return _s;
+}
+inline const std::string& RpcHeader::_internal_error_text() const {
+  return _impl_.error_text_.Get();
+}
+inline void RpcHeader::_internal_set_error_text(const std::string& value) {
+  
+  _impl_.error_text_.Set(value, GetArenaForAllocation());
+}
+inline std::string* RpcHeader::_internal_mutable_error_text() {
+  
+  return _impl_.error_text_.Mutable(GetArenaForAllocation());
+}
+inline std::string* RpcHeader::release_error_text() {
+  // @@protoc_insertion_point(field_release:mprpc.RpcHeader.error_text)
+  return _impl_.error_text_.Release();
+}
+inline void RpcHeader::set_allocated_error_text(std::string* error_text) {
+  if (error_text != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.error_text_.SetAllocated(error_text, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.error_text_.IsDefault()) {
+    _impl_.error_text_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:mprpc.RpcHeader.error_text)
+}
+
+// uint32 method_id = 7;
+inline void RpcHeader::clear_method_id() {
+  _impl_.method_id_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_method_id() const {
+  return _impl_.method_id_;
+}
+inline uint32_t RpcHeader::method_id() const {
+  // @@protoc_insertion_point(field_get:mprpc.RpcHeader.method_id)
+  return _internal_method_id();
+}
+inline void RpcHeader::_internal_set_method_id(uint32_t value) {
+  
+  _impl_.method_id_ = value;
+}
+inline void RpcHeader::set_method_id(uint32_t value) {
+  _internal_set_method_id(value);
+  // @@protoc_insertion_point(field_set:mprpc.RpcHeader.method_id)
+}
+
+// .mprpc.RpcFrameType frame_type = 8;
+inline void RpcHeader::clear_frame_type() {
+  _impl_.frame_type_ = 0;
+}
+inline ::mprpc::RpcFrameType RpcHeader::_internal_frame_type() const {
+  return static_cast< ::mprpc::RpcFrameType >(_impl_.frame_type_);
+}
+inline ::mprpc::RpcFrameType RpcHeader::frame_type() const {
+  // @@protoc_insertion_point(field_get:mprpc.RpcHeader.frame_type)
+  return _internal_frame_type();
+}
+inline void RpcHeader::_internal_set_frame_type(::mprpc::RpcFrameType value) {
+  
+  _impl_.frame_type_ = value;
+}
+inline void RpcHeader::set_frame_type(::mprpc::RpcFrameType value) {
+  _internal_set_frame_type(value);
+  // @@protoc_insertion_point(field_set:mprpc.RpcHeader.frame_type)
+}
+
+// uint32 timeout_ms = 9;
+inline void RpcHeader::clear_timeout_ms() {
+  _impl_.timeout_ms_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_timeout_ms() const {
+  return _impl_.timeout_ms_;
+}
+inline uint32_t RpcHeader::timeout_ms() const {
+  // @@protoc_insertion_point(field_get:mprpc.RpcHeader.timeout_ms)
+  return _internal_timeout_ms();
+}
+inline void RpcHeader::_internal_set_timeout_ms(uint32_t value) {
+  
+  _impl_.timeout_ms_ = value;
+}
+inline void RpcHeader::set_timeout_ms(uint32_t value) {
+  _internal_set_timeout_ms(value);
+  // @@protoc_insertion_point(field_set:mprpc.RpcHeader.timeout_ms)
+}
+
+// -------------------------------------------------------------------
+
+// RpcBatchItem
+
+// .mprpc.RpcHeader header = 1;
+inline bool RpcBatchItem::_internal_has_header() const {
+  return this != internal_default_instance() && _impl_.header_ != nullptr;
+}
+inline bool RpcBatchItem::has_header() const {
+  return _internal_has_header();
+}
+inline void RpcBatchItem::clear_header() {
+  if (GetArenaForAllocation() == nullptr && _impl_.header_ != nullptr) {
+    delete _impl_.header_;
+  }
+  _impl_.header_ = nullptr;
+}
+inline const ::mprpc::RpcHeader& RpcBatchItem::_internal_header() const {
+  const ::mprpc::RpcHeader* p = _impl_.header_;
+  return p != nullptr ? *p : reinterpret_cast<const ::mprpc::RpcHeader&>(
+      ::mprpc::_RpcHeader_default_instance_);
+}
+inline const ::mprpc::RpcHeader& RpcBatchItem::header() const {
+  // @@protoc_insertion_point(field_get:mprpc.RpcBatchItem.header)
+  return _internal_header();
+}
+inline void RpcBatchItem::unsafe_arena_set_allocated_header(
+    ::mprpc::RpcHeader* header) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(_impl_.header_);
+  }
+  _impl_.header_ = header;
+  if (header) {
+    
+  } else {
+    
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:mprpc.RpcBatchItem.header)
+}
+inline ::mprpc::RpcHeader* RpcBatchItem::release_header() {
+  
+  ::mprpc::RpcHeader* temp = _impl_.header_;
+  _impl_.header_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
+}
+inline ::mprpc::RpcHeader* RpcBatchItem::unsafe_arena_release_header() {
+  // @@protoc_insertion_point(field_release:mprpc.RpcBatchItem.header)
+  
+  ::mprpc::RpcHeader* temp = _impl_.header_;
+  _impl_.header_ = nullptr;
+  return temp;
+}
+inline ::mprpc::RpcHeader* RpcBatchItem::_internal_mutable_header() {
+  
+  if (_impl_.header_ == nullptr) {
+    auto* p = CreateMaybeMessage<::mprpc::RpcHeader>(GetArenaForAllocation());
+    _impl_.header_ = p;
+  }
+  return _impl_.header_;
+}
+inline ::mprpc::RpcHeader* RpcBatchItem::mutable_header() {
+  ::mprpc::RpcHeader* _msg = _internal_mutable_header();
+  // @@protoc_insertion_point(field_mutable:mprpc.RpcBatchItem.header)
+  return _msg;
+}
+inline void RpcBatchItem::set_allocated_header(::mprpc::RpcHeader* header) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete _impl_.header_;
+  }
+  if (header) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(header);
+    if (message_arena != submessage_arena) {
+      header = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, header, submessage_arena);
+    }
+    
+  } else {
+    
+  }
+  _impl_.header_ = header;
+  // @@protoc_insertion_point(field_set_allocated:mprpc.RpcBatchItem.header)
+}
+
+// bytes args = 2;
+inline void RpcBatchItem::clear_args() {
+  _impl_.args_.ClearToEmpty();
+}
+inline const std::string& RpcBatchItem::args() const {
+  // @@protoc_insertion_point(field_get:mprpc.RpcBatchItem.args)
+  return _internal_args();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void RpcBatchItem::set_args(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.args_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:mprpc.RpcBatchItem.args)
+}
+inline std::string* RpcBatchItem::mutable_args() {
+  std::string* _s = _internal_mutable_args();
+  // @@protoc_insertion_point(field_mutable:mprpc.RpcBatchItem.args)
+  return _s;
+}
+inline const std::string& RpcBatchItem::_internal_args() const {
+  return _impl_.args_.Get();
+}
+inline void RpcBatchItem::_internal_set_args(const std::string& value) {
+  
+  _impl_.args_.Set(value, GetArenaForAllocation());
+}
+inline std::string* RpcBatchItem::_internal_mutable_args() {
+  
+  return _impl_.args_.Mutable(GetArenaForAllocation());
+}
+inline std::string* RpcBatchItem::release_args() {
+  // @@protoc_insertion_point(field_release:mprpc.RpcBatchItem.args)
+  return _impl_.args_.Release();
+}
+inline void RpcBatchItem::set_allocated_args(std::string* args) {
+  if (args != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.args_.SetAllocated(args, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.args_.IsDefault()) {
+    _impl_.args_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:mprpc.RpcBatchItem.args)
+}
+
+// -------------------------------------------------------------------
+
+// RpcBatch
+
+// repeated .mprpc.RpcBatchItem items = 1;
+inline int RpcBatch::_internal_items_size() const {
+  return _impl_.items_.size();
+}
+inline int RpcBatch::items_size() const {
+  return _internal_items_size();
+}
+inline void RpcBatch::clear_items() {
+  _impl_.items_.Clear();
+}
+inline ::mprpc::RpcBatchItem* RpcBatch::mutable_items(int index) {
+  // @@protoc_insertion_point(field_mutable:mprpc.RpcBatch.items)
+  return _impl_.items_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::mprpc::RpcBatchItem >*
+RpcBatch::mutable_items() {
+  // @@protoc_insertion_point(field_mutable_list:mprpc.RpcBatch.items)
+  return &_impl_.items_;
+}
+inline const ::mprpc::RpcBatchItem& RpcBatch::_internal_items(int index) const {
+  return _impl_.items_.Get(index);
+}
+inline const ::mprpc::RpcBatchItem& RpcBatch::items(int index) const {
+  // @@protoc_insertion_point(field_get:mprpc.RpcBatch.items)
+  return _internal_items(index);
+}
+inline ::mprpc::RpcBatchItem* RpcBatch::_internal_add_items() {
+  return _impl_.items_.Add();
+}
+inline ::mprpc::RpcBatchItem* RpcBatch::add_items() {
+  ::mprpc::RpcBatchItem* _add = _internal_add_items();
+  // @@protoc_insertion_point(field_add:mprpc.RpcBatch.items)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::mprpc::RpcBatchItem >&
+RpcBatch::items() const {
+  // @@protoc_insertion_point(field_list:mprpc.RpcBatch.items)
+  return _impl_.items_;
+}
+
 #ifdef __GNUC__
   #pragma GCC diagnostic pop
 #endif  // __GNUC__
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
 }  // namespace mprpc
 
+PROTOBUF_NAMESPACE_OPEN
+
+template <> struct is_proto_enum< ::mprpc::RpcErrorCode> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::mprpc::RpcErrorCode>() {
+  return ::mprpc::RpcErrorCode_descriptor();
+}
+template <> struct is_proto_enum< ::mprpc::RpcFrameType> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::mprpc::RpcFrameType>() {
+  return ::mprpc::RpcFrameType_descriptor();
+}
+
+PROTOBUF_NAMESPACE_CLOSE
+
 // @@protoc_insertion_point(global_scope)
 
 #include <google/protobuf/port_undef.inc>
@@ -0,0 +1,28 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+// mprpc 帧格式：[4字节头部长度] [RPC头部] [数据]，请求和长连接响应共用
+
+// 帧长度字段占用的字节数
+const size_t kRpcHeaderLenBytes = 4;
+// 单个 RPC 头部/数据允许的最大长度，超过视为非法数据
+const uint32_t kRpcMaxHeaderSize = 64 * 1024;
+const uint32_t kRpcMaxArgsSize = 64 * 1024 * 1024;
+
+/**
+ * @brief 计算方法 ID：方法全名（package.Service.Method）的 32 位 FNV-1a 哈希
+ *
+ * 客户端和服务端各自独立计算，结果稳定，不依赖注册顺序。0 保留表示“未携带 ID”。
+ */
+inline uint32_t RpcMethodId(const std::string &full_name)
+{
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : full_name)
+    {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash == 0 ? 1 : hash;
+}
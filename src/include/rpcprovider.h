@@ -7,6 +7,12 @@
 #include <muduo/net/TcpConnection.h>
 #include <google/protobuf/descriptor.h>
 #include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "rpcheader.pb.h"
+#include "threadpool.h"
+#include "mprpccontroller.h"
 
 class RpcProvider
 {
@@ -14,8 +20,12 @@ public:
     void NotifyService(::google::protobuf::Service *service);
     void Run();
 
+    struct RpcArena; // 可复用的 protobuf Arena，定义见 rpcprovider.cpp
+
 private:
     muduo::net::EventLoop m_eventLoop;
+    std::unique_ptr<ThreadPool> m_workerPool; // 业务线程池，未配置时为空
+    size_t m_highWaterMark;                   // 每个连接输出缓冲区的高水位（字节）
 
     struct ServiceInfo
     {
@@ -24,9 +34,86 @@ private:
     };
     std::unordered_map<std::string, ServiceInfo> m_serviceMap;
 
+    // 方法 ID 分发表项，m_methodId 为 0 表示空槽
+    struct MethodEntry
+    {
+        uint32_t m_methodId;
+        google::protobuf::Service *m_service;
+        const google::protobuf::MethodDescriptor *m_method;
+    };
+    std::vector<MethodEntry> m_methodTable; // 开放寻址表，NotifyService 时构建，之后只读
+
+    // 批量请求的上下文，最后一项完成后整批发送并释放
+    struct BatchCall
+    {
+        muduo::net::TcpConnectionPtr m_conn;
+        uint64_t m_requestId;
+        std::atomic<int> m_pending;       // 尚未完成的项数
+        mprpc::RpcBatch m_responses;      // 各项的响应，顺序与请求一致
+        std::vector<RpcArena *> m_arenas; // 各项使用的 Arena，整批发送后统一归还
+    };
+
+    // 一次 RPC 调用的上下文，由 done 回调负责释放
+    struct RpcCall
+    {
+        uint64_t m_requestId; // 0 表示短连接请求
+        RpcArena *m_arena;    // 请求/响应所在的 Arena
+        BatchCall *m_batch;   // 所属的批量请求，单个请求为 nullptr
+        int m_batchIndex;
+        MprpcController *m_controller;
+        mprpc::RpcErrorCode m_errorCode; // 未执行服务方法时的原因（超时/已取消），正常为 RPC_OK
+        google::protobuf::Message *m_request;
+        google::protobuf::Message *m_response;
+    };
+
+    // 每个连接上正在执行的调用，按 request_id 索引，用于处理取消帧和连接断开；保存在 muduo 连接的 context 中
+    struct ConnectionState
+    {
+        std::recursive_mutex m_mutex; // 取消回调中服务方法可能直接结束调用，再次加锁
+        std::unordered_multimap<uint64_t, MprpcController *> m_inflight;
+    };
+    using ConnectionStatePtr = std::shared_ptr<ConnectionState>;
+
+    // 服务方法的 done 回调，线程安全，可在任意线程调用一次
+    class RpcDoneClosure : public google::protobuf::Closure
+    {
+    public:
+        RpcDoneClosure(RpcProvider *provider, const muduo::net::TcpConnectionPtr &conn, RpcCall *call);
+        void Run() override;
+
+    private:
+        RpcProvider *m_provider;
+        muduo::net::TcpConnectionPtr m_conn;
+        RpcCall *m_call;
+    };
+
+    void AddMethodId(uint32_t, google::protobuf::Service *, const google::protobuf::MethodDescriptor *);
+    const MethodEntry *FindMethod(uint32_t) const;
+
+    static RpcArena *AcquireArena();
+    static void ReleaseArena(RpcArena *);
+
     void OnConnection(const muduo::net::TcpConnectionPtr &);
+    void OnHighWaterMark(const muduo::net::TcpConnectionPtr &, size_t);
+    void OnWriteComplete(const muduo::net::TcpConnectionPtr &);
 
     void OnMessage(const muduo::net::TcpConnectionPtr &, muduo::net::Buffer *, muduo::Timestamp);
+    void HandleRequest(const muduo::net::TcpConnectionPtr &, const mprpc::RpcHeader &, const char *, size_t,
+                       BatchCall *, int);
+    static ConnectionState *GetConnectionState(const muduo::net::TcpConnectionPtr &);
+    static void RegisterCall(const muduo::net::TcpConnectionPtr &, RpcCall *);
+    static void UnregisterCall(const muduo::net::TcpConnectionPtr &, RpcCall *);
+    static void CancelCalls(const muduo::net::TcpConnectionPtr &, uint64_t, bool);
+    static void InvokeMethod(google::protobuf::Service *, const google::protobuf::MethodDescriptor *, RpcCall *,
+                             google::protobuf::Closure *);
+    void HandleBatch(const muduo::net::TcpConnectionPtr &, const mprpc::RpcHeader &, const char *);
+    static void FailBatchItem(BatchCall *, int, mprpc::RpcErrorCode, const std::string &);
+    static void CompleteBatchItem(RpcCall *);
+    static void FinishBatchItem(BatchCall *);
 
-    void SendRpcResponse(const muduo::net::TcpConnectionPtr &, google::protobuf::Message *);
+    void SendRpcResponse(const muduo::net::TcpConnectionPtr &, RpcCall *);
+    void SendRpcError(const muduo::net::TcpConnectionPtr &, uint64_t, mprpc::RpcErrorCode, const std::string &);
+    static void EncodeRpcResponse(RpcCall *, muduo::net::Buffer *);
+    static void FinishRpcCall(const muduo::net::TcpConnectionPtr &, RpcCall *, muduo::net::Buffer *);
+    static void EncodeRpcFrame(mprpc::RpcHeader *, const google::protobuf::Message *, muduo::net::Buffer *);
 };
\ No newline at end of file
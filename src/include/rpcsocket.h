@@ -0,0 +1,17 @@
+#pragma once
+#include <chrono>
+#include <stdint.h>
+#include <sys/socket.h>
+
+// 同步调用（短连接和连接池）共用的带截止时间的套接字操作
+
+// 没有截止时间
+const std::chrono::steady_clock::time_point kNoDeadline = std::chrono::steady_clock::time_point::max();
+
+// 距截止时间的剩余毫秒数，不足 1 毫秒按 1 毫秒算，已超时返回 0
+int64_t RemainingMs(std::chrono::steady_clock::time_point deadline);
+// 等待 fd 可读/可写，超过截止时间返回 false 并把 errno 置为 ETIMEDOUT；没有截止时间时直接返回 true
+bool WaitFd(int fd, short events, std::chrono::steady_clock::time_point deadline);
+// 连接服务端；有截止时间时使用非阻塞 connect 并等待到截止时间，fd 之后保持非阻塞
+bool ConnectWithDeadline(int fd, const struct sockaddr *addr, socklen_t addr_len,
+                         std::chrono::steady_clock::time_point deadline);
@@ -0,0 +1,27 @@
+#pragma once
+#include "lockqueue.h"
+#include <functional>
+#include <thread>
+#include <vector>
+
+// 业务线程池：任务放入有界队列，由固定数量的工作线程执行
+class ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+    ThreadPool(int threadNum, size_t maxQueueSize);
+    ~ThreadPool();
+
+    void Start();
+    // 提交任务，队列已满时返回 false，调用方不会被阻塞
+    bool TryRun(const Task &task);
+
+private:
+    int m_threadNum;
+    LockQueue<Task> m_taskQueue;
+    std::vector<std::thread> m_threads;
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <muduo/net/Channel.h>
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/EventLoopThreadPool.h>
+#include <muduo/net/TcpConnection.h>
+
+/**
+ * @brief 在 Unix 域套接字上接受连接
+ *
+ * muduo 的 TcpServer 只能监听网络地址，这里自己监听、accept，再用接受的 fd 构造 TcpConnection，
+ * 连接按轮询分配到 TcpServer 的 I/O 线程，之后的读写、回调和关闭流程与 TCP 连接完全相同。
+ * 同一主机上的客户端经由它通信，省去回环 TCP 协议栈的开销。
+ */
+class UnixAcceptor
+{
+public:
+    UnixAcceptor(muduo::net::EventLoop *loop, const std::string &path, const std::string &name);
+    ~UnixAcceptor();
+
+    void setConnectionCallback(const muduo::net::ConnectionCallback &cb) { m_connectionCallback = cb; }
+    void setMessageCallback(const muduo::net::MessageCallback &cb) { m_messageCallback = cb; }
+    void setWriteCompleteCallback(const muduo::net::WriteCompleteCallback &cb) { m_writeCompleteCallback = cb; }
+
+    // 开始监听，需在 TcpServer::start() 之后调用，连接分配到 ioLoops；失败时返回 false
+    bool Start(const std::shared_ptr<muduo::net::EventLoopThreadPool> &ioLoops);
+
+private:
+    muduo::net::EventLoop *m_loop; // 接受连接的线程
+    std::string m_path;
+    std::string m_name;
+    int m_listenFd;
+    int m_nextConnId;
+    std::unique_ptr<muduo::net::Channel> m_channel;
+    std::shared_ptr<muduo::net::EventLoopThreadPool> m_ioLoops;
+    std::map<std::string, muduo::net::TcpConnectionPtr> m_connections; // 只在 m_loop 中访问
+
+    muduo::net::ConnectionCallback m_connectionCallback;
+    muduo::net::MessageCallback m_messageCallback;
+    muduo::net::WriteCompleteCallback m_writeCompleteCallback;
+
+    void HandleRead();
+    void NewConnection(int fd);
+    void RemoveConnection(const muduo::net::TcpConnectionPtr &conn);
+
+    UnixAcceptor(const UnixAcceptor &) = delete;
+    UnixAcceptor &operator=(const UnixAcceptor &) = delete;
+};
@@ -0,0 +1,63 @@
+#include "latencytracker.h"
+#include "mprpcapplication.h"
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+// 默认取 95 分位
+static const int kDefaultHedgePercentile = 95;
+
+// 分位数，来自配置项 rpchedgepercentile
+static int HedgePercentile()
+{
+    static int percentile = []()
+    {
+        std::string value = MprpcApplication::getInstance().GetConfig().Load("rpchedgepercentile");
+        int p = value.empty() ? kDefaultHedgePercentile : atoi(value.c_str());
+        return std::min(std::max(p, 1), 99);
+    }();
+    return percentile;
+}
+
+LatencyTracker *LatencyTracker::ForMethod(const std::string &full_name)
+{
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::unique_ptr<LatencyTracker>> trackers;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<LatencyTracker> &tracker = trackers[full_name];
+    if (!tracker)
+    {
+        tracker.reset(new LatencyTracker);
+    }
+    return tracker.get();
+}
+
+/**
+ * @brief 记录一次调用耗时
+ *
+ * 分位数不必每次都算：每积累 kRecomputeEvery 个新样本，对窗口做一次 nth_element，
+ * 结果存在原子变量中，读取时不加锁。
+ */
+void LatencyTracker::Record(int64_t latency_us)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_samples.size() < kWindowSize)
+    {
+        m_samples.push_back(latency_us);
+    }
+    else
+    {
+        m_samples[m_next] = latency_us;
+    }
+    m_next = (m_next + 1) % kWindowSize;
+
+    if (++m_sinceRecompute < kRecomputeEvery)
+    {
+        return;
+    }
+    m_sinceRecompute = 0;
+    std::vector<int64_t> sorted(m_samples);
+    size_t idx = sorted.size() * HedgePercentile() / 100;
+    std::nth_element(sorted.begin(), sorted.begin() + idx, sorted.end());
+    m_percentile.store(sorted[idx], std::memory_order_relaxed);
+}
@@ -0,0 +1,113 @@
+#include "loadbalancer.h"
+#include "mprpcapplication.h"
+#include <iostream>
+#include <random>
+
+// 每个线程一个随机数发生器，避免加锁
+static size_t RandomIndex(size_t n)
+{
+    static thread_local std::mt19937 t_engine(std::random_device{}());
+    return std::uniform_int_distribution<size_t>(0, n - 1)(t_engine);
+}
+
+LoadBalancer *LoadBalancer::Create(const std::string &name)
+{
+    if (name == "roundrobin")
+        return new RoundRobinLoadBalancer;
+    if (name == "weighted")
+        return new WeightedLoadBalancer;
+    if (name == "leastrequests")
+        return new LeastRequestsLoadBalancer;
+    if (name == "p2c")
+        return new PowerOfTwoChoicesLoadBalancer;
+    return nullptr;
+}
+
+LoadBalancer *LoadBalancer::Default()
+{
+    static LoadBalancer *balancer = []()
+    {
+        std::string name = MprpcApplication::getInstance().GetConfig().Load("rpcloadbalance");
+        LoadBalancer *lb = Create(name.empty() ? "roundrobin" : name);
+        if (lb == nullptr)
+        {
+            std::cout << "unknown rpcloadbalance: " << name << ", use roundrobin" << std::endl;
+            lb = new RoundRobinLoadBalancer;
+        }
+        return lb;
+    }();
+    return balancer;
+}
+
+size_t RoundRobinLoadBalancer::Select(const std::vector<ServiceEndpoint> &endpoints)
+{
+    return m_next.fetch_add(1, std::memory_order_relaxed) % endpoints.size();
+}
+
+size_t WeightedLoadBalancer::Select(const std::vector<ServiceEndpoint> &endpoints)
+{
+    int total = 0;
+    for (const ServiceEndpoint &endpoint : endpoints)
+    {
+        total += endpoint.m_weight;
+    }
+    int pick = RandomIndex(total);
+    for (size_t i = 0; i < endpoints.size(); ++i)
+    {
+        pick -= endpoints[i].m_weight;
+        if (pick < 0)
+        {
+            return i;
+        }
+    }
+    return endpoints.size() - 1;
+}
+
+size_t LeastRequestsLoadBalancer::Select(const std::vector<ServiceEndpoint> &endpoints)
+{
+    size_t n = endpoints.size();
+    size_t start = RandomIndex(n);
+    size_t best = start;
+    int best_outstanding = endpoints[start].m_state->m_outstanding.load(std::memory_order_relaxed);
+    for (size_t k = 1; k < n; ++k)
+    {
+        size_t i = (start + k) % n;
+        int outstanding = endpoints[i].m_state->m_outstanding.load(std::memory_order_relaxed);
+        if (outstanding < best_outstanding)
+        {
+            best = i;
+            best_outstanding = outstanding;
+        }
+    }
+    return best;
+}
+
+size_t PowerOfTwoChoicesLoadBalancer::Select(const std::vector<ServiceEndpoint> &endpoints)
+{
+    size_t n = endpoints.size();
+    if (n == 1)
+    {
+        return 0;
+    }
+    size_t a = RandomIndex(n);
+    size_t b = RandomIndex(n - 1);
+    if (b >= a)
+    {
+        b++; // 保证与 a 不同
+    }
+    int outstanding_a = endpoints[a].m_state->m_outstanding.load(std::memory_order_relaxed);
+    int outstanding_b = endpoints[b].m_state->m_outstanding.load(std::memory_order_relaxed);
+    return outstanding_a <= outstanding_b ? a : b;
+}
+
+size_t PinnedLoadBalancer::Select(const std::vector<ServiceEndpoint> &endpoints)
+{
+    for (size_t i = 0; i < endpoints.size(); ++i)
+    {
+        if (endpoints[i].m_host == m_host)
+        {
+            return i;
+        }
+    }
+    return endpoints.size();
+}
@@ -8,32 +8,799 @@
 #include "mprpcapplication.h"
 #include "mprpccontroller.h"
 #include <unistd.h>
-#include "zookeeperutil.h"
+#include "servicediscovery.h"
+#include "rpcprotocol.h"
+#include "connectionpool.h"
+#include "rpcclient.h"
+#include "latencytracker.h"
+#include "mprpcoptions.pb.h"
+#include "responsecache.h"
+#include "singleflight.h"
+#include "rpcaddress.h"
+#include "rpcsocket.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <poll.h>
+#include <condition_variable>
+#include <mutex>
 
-void MprpcChannel::CallMethod(const google::protobuf::MethodDescriptor *method, google::protobuf::RpcController *controller, const google::protobuf::Message *request, google::protobuf::Message *response, google::protobuf::Closure *done)
+// 长连接模式下的请求序号，进程内唯一，从 1 开始（0 表示短连接）
+static std::atomic<uint64_t> g_requestId(0);
+
+using Clock = std::chrono::steady_clock;
+
+// 取 controller 上的截止时间，controller 不是 MprpcController 或未设置时返回 kNoDeadline
+static Clock::time_point GetDeadline(google::protobuf::RpcController *controller)
 {
-    const google::protobuf::ServiceDescriptor *sd = method->service();
-    std::string service_name = sd->name();
-    std::string method_name = method->name();
+    MprpcController *mprpcController = dynamic_cast<MprpcController *>(controller);
+    if (mprpcController == nullptr || !mprpcController->HasDeadline())
+    {
+        return kNoDeadline;
+    }
+    return mprpcController->Deadline();
+}
 
-    uint32_t args_size = 0;
-    std::string args_str;
+// 交给客户端 I/O 线程的超时时间，0 表示没有截止时间
+static int64_t TimeoutMs(Clock::time_point deadline)
+{
+    return deadline == kNoDeadline ? 0 : std::max<int64_t>(RemainingMs(deadline), 1);
+}
 
-    if (request->SerializeToString(&args_str))
+// 套接字操作失败时的错误信息，超时统一报告为 deadline exceeded
+static std::string SocketError(const char *what)
+{
+    if (errno == ETIMEDOUT)
     {
-        args_size = args_str.size();
+        return "deadline exceeded";
     }
-    else
+    return std::string(what) + " error! errno: " + std::to_string(errno);
+}
+
+/**
+ * @brief 发送全部数据，处理部分写
+ *
+ * 有截止时间时先 poll 等待可写再以非阻塞方式发送，超时返回 false（errno 为 ETIMEDOUT）。
+ */
+static bool SendAll(int fd, const char *data, size_t len, Clock::time_point deadline = kNoDeadline)
+{
+    int flags = MSG_NOSIGNAL | (deadline != kNoDeadline ? MSG_DONTWAIT : 0);
+    while (len > 0)
+    {
+        if (!WaitFd(fd, POLLOUT, deadline))
+            return false;
+        ssize_t n = send(fd, data, len, flags);
+        if (n == -1)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            return false;
+        }
+        data += n;
+        len -= n;
+    }
+    return true;
+}
+
+// 接收恰好 len 字节，返回已接收的字节数，小于 len 表示对端关闭、出错或超时（errno 为 ETIMEDOUT）
+static size_t RecvAll(int fd, char *data, size_t len, Clock::time_point deadline = kNoDeadline)
+{
+    int flags = deadline != kNoDeadline ? MSG_DONTWAIT : 0;
+    size_t got = 0;
+    while (got < len)
+    {
+        if (!WaitFd(fd, POLLIN, deadline))
+            break;
+        ssize_t n = recv(fd, data + got, len - got, flags);
+        if (n == -1 && (errno == EINTR || errno == EAGAIN))
+            continue;
+        if (n <= 0)
+            break;
+        got += n;
+    }
+    return got;
+}
+
+// 同步调用的接收缓冲区，每个线程一份，按需增长并在多次调用间复用，不随每次调用分配
+static thread_local std::string t_recvBuffer;
+
+/**
+ * @brief 读取一帧响应：[4字节头部长度] [RPC头部] [响应数据]，响应大小不受限制
+ * @param payload 接收缓冲区，返回时内容为响应数据；头部也先读入其中，免去额外分配
+ * @return 1 成功；0 对端在发送任何数据前关闭了连接；-1 出错或超时
+ */
+static int RecvFrame(int fd, mprpc::RpcHeader *rpcHeader, std::string *payload, Clock::time_point deadline = kNoDeadline)
+{
+    uint32_t header_size = 0;
+    size_t got = RecvAll(fd, (char *)&header_size, kRpcHeaderLenBytes, deadline);
+    if (got == 0 && errno != ETIMEDOUT)
+        return 0;
+    if (got != kRpcHeaderLenBytes || header_size > kRpcMaxHeaderSize)
+        return -1;
+
+    payload->resize(header_size);
+    if (RecvAll(fd, &(*payload)[0], header_size, deadline) != header_size ||
+        !rpcHeader->ParseFromArray(payload->data(), header_size))
+        return -1;
+
+    if (rpcHeader->args_size() > kRpcMaxArgsSize)
+        return -1;
+    payload->resize(rpcHeader->args_size());
+    if (RecvAll(fd, &(*payload)[0], payload->size(), deadline) != payload->size())
+        return -1;
+    return 1;
+}
+
+// 查询方法的服务端列表，失败时设置错误信息
+// 列表来自进程级的服务发现缓存，通常不访问 ZooKeeper
+static EndpointList LookupEndpoints(const google::protobuf::MethodDescriptor *method,
+                                    google::protobuf::RpcController *controller)
+{
+    std::string method_path = "/" + method->service()->name() + "/" + method->name();
+    EndpointList endpoints = ServiceDiscovery::getInstance().Lookup(method_path);
+    if (endpoints == nullptr || endpoints->empty())
+    {
+        controller->SetFailed(method_path + " is not exist!!");
+        return nullptr;
+    }
+    return endpoints;
+}
+
+// ---------------------------- 服务端健康 ----------------------------
+/**
+ * @brief 把一次调用的结果计入服务端的健康统计
+ *
+ * 传输错误，以及服务端过载（RPC_SERVER_BUSY）或排队超时都算作失败；
+ * 取消和调用方自己的截止时间到期由调用方决定，不计入；其余服务端返回的错误说明服务端工作正常，按成功计。
+ */
+static void RecordResult(EndpointState *state, Clock::time_point start, const std::string &error,
+                         const mprpc::RpcHeader *rspHeader)
+{
+    if (error == "canceled" || error == "deadline exceeded")
+    {
+        return;
+    }
+    bool failed = !error.empty() ||
+                  (rspHeader != nullptr && (rspHeader->error_code() == mprpc::RPC_SERVER_BUSY ||
+                                            rspHeader->error_code() == mprpc::RPC_DEADLINE_EXCEEDED));
+    state->m_breaker.Record(failed, std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+}
+
+// 同步调用期间把请求计入服务端的未完成请求数，供负载均衡参考；Finish 记录调用结果
+class OutstandingGuard
+{
+public:
+    explicit OutstandingGuard(EndpointState *state) : m_state(state), m_start(Clock::now()) { m_state->m_outstanding++; }
+    ~OutstandingGuard() { m_state->m_outstanding--; }
+
+    void Finish(const std::string &error, const mprpc::RpcHeader *rspHeader)
+    {
+        RecordResult(m_state, m_start, error, rspHeader);
+    }
+
+private:
+    EndpointState *m_state;
+    Clock::time_point m_start;
+};
+
+/**
+ * @brief 去掉被熔断摘除的服务端，并摘除耗时明显偏高的服务端
+ *
+ * 耗时的指数移动平均超过同一方法中最快服务端的 rpcoutlierlatencyfactor 倍（默认 3，0 表示不检查）
+ * 且至少慢 1 毫秒时视为异常，摘除方式与熔断相同。
+ * @return 有服务端被去掉时返回 true，剩余的放入 healthy；全部可用时返回 false，不填充 healthy
+ */
+static bool FilterHealthy(const std::vector<ServiceEndpoint> &endpoints, std::vector<ServiceEndpoint> *healthy)
+{
+    static double factor = []()
+    {
+        std::string value = MprpcApplication::getInstance().GetConfig().Load("rpcoutlierlatencyfactor");
+        return value.empty() ? 3.0 : atof(value.c_str());
+    }();
+    static const int64_t kMinOutlierGapUs = 1000;
+
+    int64_t fastest = -1;
+    size_t measured = 0;
+    for (const ServiceEndpoint &endpoint : endpoints)
+    {
+        int64_t latency = endpoint.m_state->m_breaker.LatencyEwma();
+        if (latency >= 0 && endpoint.m_state->m_breaker.Available())
+        {
+            fastest = fastest < 0 ? latency : std::min(fastest, latency);
+            measured++;
+        }
+    }
+    if (factor > 0 && measured >= 2)
+    {
+        for (const ServiceEndpoint &endpoint : endpoints)
+        {
+            int64_t latency = endpoint.m_state->m_breaker.LatencyEwma();
+            if (latency > fastest * factor && latency - fastest > kMinOutlierGapUs)
+            {
+                endpoint.m_state->m_breaker.Eject();
+            }
+        }
+    }
+
+    size_t available = 0;
+    for (const ServiceEndpoint &endpoint : endpoints)
+    {
+        available += endpoint.m_state->m_breaker.Available() ? 1 : 0;
+    }
+    if (available == endpoints.size())
+    {
+        return false;
+    }
+    healthy->clear();
+    for (const ServiceEndpoint &endpoint : endpoints)
+    {
+        if (endpoint.m_state->m_breaker.Available())
+        {
+            healthy->push_back(endpoint);
+        }
+    }
+    return true;
+}
+
+// 检查响应帧的状态码并解析响应数据，失败时设置错误信息并返回 false
+static bool ParseResponse(const mprpc::RpcHeader &rspHeader, const std::string &response_str,
+                          google::protobuf::RpcController *controller, google::protobuf::Message *response)
+{
+    if (rspHeader.error_code() != mprpc::RPC_OK)
+    {
+        controller->SetFailed(rspHeader.error_text());
+        return false;
+    }
+    if (!response->ParseFromString(response_str))
+    {
+        controller->SetFailed("parse response error!");
+        return false;
+    }
+    return true;
+}
+
+// 经由客户端 I/O 线程发送，请求在途期间计入服务端的未完成请求数，结果计入服务端的健康统计
+static void SendTracked(const ServiceEndpoint &endpoint, uint64_t request_id, const std::string &frame,
+                        int64_t timeout_ms, RpcClient::ResponseCallback cb)
+{
+    EndpointState *state = endpoint.m_state;
+    state->m_outstanding++;
+    Clock::time_point start = Clock::now();
+    RpcClient::getInstance().Send(endpoint.m_address, request_id, frame,
+                                  [state, start, cb](const std::string &error, const mprpc::RpcHeader &rspHeader,
+                                                     const char *payload, size_t payload_size)
+                                  {
+        state->m_outstanding--;
+        RecordResult(state, start, error, &rspHeader);
+        cb(error, rspHeader, payload, payload_size); }, timeout_ms);
+}
+
+// 对冲延迟：方法最近耗时的分位数，样本不足时使用配置项 rpchedgedelayms（默认 20 毫秒）
+static int64_t HedgeDelayMs(LatencyTracker *tracker)
+{
+    static int64_t initial_delay = []()
+    {
+        std::string value = MprpcApplication::getInstance().GetConfig().Load("rpchedgedelayms");
+        return value.empty() ? 20 : atoll(value.c_str());
+    }();
+    int64_t percentile_us = tracker->Percentile();
+    return percentile_us < 0 ? initial_delay : std::max<int64_t>(percentile_us / 1000, 1);
+}
+
+/**
+ * @brief 对冲发送：先把请求发给 primary，超过对冲延迟仍未完成时再发给 backup
+ *
+ * 两路请求使用同一帧（同一个 request_id，分属两条连接），先到的响应生效，另一路随即取消；
+ * 一路出错而另一路仍在进行时等待另一路的结果。cb 只回调一次，
+ * 所有状态只在客户端 I/O 线程中访问，不需要加锁。胜出一路的耗时计入方法的耗时统计。
+ */
+static void SendHedged(const ServiceEndpoint &primary, const ServiceEndpoint &backup, LatencyTracker *tracker,
+                       uint64_t request_id, const std::string &frame, int64_t timeout_ms,
+                       RpcClient::ResponseCallback cb)
+{
+    struct HedgeState
+    {
+        RpcClient::ResponseCallback m_cb;
+        bool m_finished = false;
+        ServiceEndpoint m_endpoints[2];      // 0 为主请求，1 为备份请求
+        bool m_inflight[2] = {false, false}; // 该路请求是否还在进行
+        Clock::time_point m_sendTime[2];
+    };
+    std::shared_ptr<HedgeState> state = std::make_shared<HedgeState>();
+    state->m_cb = std::move(cb);
+    state->m_endpoints[0] = primary;
+    state->m_endpoints[1] = backup;
+
+    // 发出第 i 路请求
+    auto issue = [state, tracker, request_id, frame](int i, int64_t timeout)
+    {
+        state->m_inflight[i] = true;
+        state->m_sendTime[i] = Clock::now();
+        state->m_endpoints[i].m_state->m_outstanding++;
+        RpcClient::getInstance().Send(state->m_endpoints[i].m_address, request_id, frame,
+                                      [state, tracker, request_id, i](const std::string &error, const mprpc::RpcHeader &rspHeader,
+                                                                      const char *payload, size_t payload_size)
+                                      {
+            // 已被放弃的一路：胜出一路已替它做了计数，取消排队执行前它的响应仍可能先到，直接丢弃
+            if (!state->m_inflight[i])
+            {
+                return;
+            }
+            state->m_inflight[i] = false;
+            state->m_endpoints[i].m_state->m_outstanding--;
+            RecordResult(state->m_endpoints[i].m_state, state->m_sendTime[i], error, &rspHeader);
+            int other = 1 - i;
+            if (state->m_finished || (!error.empty() && state->m_inflight[other]))
+            {
+                return;
+            }
+            state->m_finished = true;
+            if (error.empty())
+            {
+                tracker->Record(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - state->m_sendTime[i]).count());
+            }
+            if (state->m_inflight[other])
+            {
+                // 取消落后的一路，它的响应到达后会被丢弃
+                state->m_inflight[other] = false;
+                state->m_endpoints[other].m_state->m_outstanding--;
+                RpcClient::getInstance().Cancel(state->m_endpoints[other].m_address, request_id);
+            }
+            state->m_cb(error, rspHeader, payload, payload_size); }, timeout);
+    };
+
+    issue(0, timeout_ms);
+    int64_t delay = HedgeDelayMs(tracker);
+    if (timeout_ms > 0 && delay >= timeout_ms)
+    {
+        return; // 截止时间之前来不及对冲
+    }
+    RpcClient::getInstance().RunAfter(delay, [state, issue, timeout_ms, delay]()
+                                      {
+        if (!state->m_finished)
+        {
+            issue(1, timeout_ms > 0 ? timeout_ms - delay : 0);
+        } });
+}
+
+// ---------------------------- 取消 ----------------------------
+/**
+ * @brief 经由客户端 I/O 线程发送，发送前在 controller 上登记取消处理，回调时注销
+ *
+ * StartCancel 时通过 cancel 放弃请求（通知服务端，并以 "canceled" 回调）。
+ * 取消可能发生在请求交给 I/O 线程之前，此时 Cancel 先于 Send 执行而落空，所以发出后检查一次，必要时再取消。
+ * 发出之后回调可能已经执行、controller 可能已被释放，不再访问 controller。
+ */
+static void SendCancelable(const std::function<void(RpcClient::ResponseCallback)> &send, google::protobuf::RpcController *controller,
+                           const std::function<void()> &cancel, RpcClient::ResponseCallback cb)
+{
+    MprpcController *mprpcController = dynamic_cast<MprpcController *>(controller);
+    if (mprpcController == nullptr)
+    {
+        send(std::move(cb));
+        return;
+    }
+    std::shared_ptr<std::atomic<bool>> canceled = std::make_shared<std::atomic<bool>>(false);
+    if (!mprpcController->SetCancelHandler([canceled, cancel]()
+                                           {
+        canceled->store(true);
+        cancel(); }))
+    {
+        mprpc::RpcHeader emptyHeader;
+        cb("canceled", emptyHeader, nullptr, 0);
+        return;
+    }
+    send([mprpcController, cb](const std::string &error, const mprpc::RpcHeader &rspHeader,
+                               const char *payload, size_t payload_size)
+         {
+        mprpcController->SetCancelHandler(nullptr);
+        cb(error, rspHeader, payload, payload_size); });
+    if (canceled->load())
+    {
+        cancel();
+    }
+}
+
+// 同步调用阻塞在套接字上期间登记取消处理：取消时关闭 fd 的读写，阻塞中的 send/recv 随即返回。
+// 已被取消时设置错误信息并返回 false
+static bool WatchCancel(google::protobuf::RpcController *controller, int fd)
+{
+    MprpcController *mprpcController = dynamic_cast<MprpcController *>(controller);
+    if (mprpcController != nullptr && !mprpcController->SetCancelHandler([fd]()
+                                                                         { shutdown(fd, SHUT_RDWR); }))
+    {
+        mprpcController->SetCancelHandler(nullptr);
+        controller->SetFailed("canceled");
+        return false;
+    }
+    return true;
+}
+
+// 注销取消处理，返回后 fd 不会再被关闭；调用已被取消时设置错误信息并返回 true，此时 fd 不能再复用
+static bool UnwatchCancel(google::protobuf::RpcController *controller)
+{
+    MprpcController *mprpcController = dynamic_cast<MprpcController *>(controller);
+    if (mprpcController != nullptr && !mprpcController->SetCancelHandler(nullptr))
+    {
+        controller->SetFailed("canceled");
+        return true;
+    }
+    return false;
+}
+
+// ---------------------------- 请求合并 ----------------------------
+// 是否合并相同的请求，由配置项 rpcsingleflight 控制，默认开启，设为 0 关闭
+static bool SingleFlightEnabled()
+{
+    static bool enabled = MprpcApplication::getInstance().GetConfig().Load("rpcsingleflight") != "0";
+    return enabled;
+}
+
+// 等待者取得合并调用的结果
+static void ApplyFlightResult(const std::string &error, const std::string &response_str,
+                              google::protobuf::RpcController *controller, google::protobuf::Message *response)
+{
+    if (!error.empty())
+    {
+        controller->SetFailed(error);
+    }
+    else if (!response->ParseFromString(response_str))
+    {
+        controller->SetFailed("parse response error!");
+    }
+}
+
+MprpcChannel::MprpcChannel(bool keepAlive, LoadBalancer *loadBalancer)
+    : MprpcChannel(keepAlive ? kPooled : kShortConnection, loadBalancer)
+{
+}
+
+MprpcChannel::MprpcChannel(ConnectionMode mode, LoadBalancer *loadBalancer)
+    : m_mode(mode), m_loadBalancer(loadBalancer != nullptr ? loadBalancer : LoadBalancer::Default()), m_singleFlight(true),
+      m_responseCache(true)
+{
+}
+
+// 按负载均衡策略为方法选出一个健康的服务端，失败时设置错误信息
+bool MprpcChannel::SelectEndpoint(const google::protobuf::MethodDescriptor *method,
+                                  google::protobuf::RpcController *controller, ServiceEndpoint *endpoint)
+{
+    EndpointList endpoints = LookupEndpoints(method, controller);
+    if (endpoints == nullptr)
+    {
+        return false;
+    }
+    // 只在健康的服务端中选择；全部被摘除时立即失败，不再压向已经出问题的服务端
+    std::vector<ServiceEndpoint> healthy;
+    const std::vector<ServiceEndpoint> *candidates = endpoints.get();
+    if (FilterHealthy(*endpoints, &healthy))
+    {
+        if (healthy.empty())
+        {
+            controller->SetFailed("/" + method->service()->name() + "/" + method->name() + " has no healthy provider!");
+            return false;
+        }
+        candidates = &healthy;
+    }
+    size_t index = m_loadBalancer->Select(*candidates);
+    if (index >= candidates->size())
+    {
+        controller->SetFailed("/" + method->service()->name() + "/" + method->name() + " has no selectable provider!");
+        return false;
+    }
+    *endpoint = (*candidates)[index];
+    return true;
+}
+
+// 为对冲请求选出与 primary 不同的另一个健康的服务端，没有时返回 false
+bool MprpcChannel::SelectBackup(const google::protobuf::MethodDescriptor *method, const ServiceEndpoint &primary,
+                                ServiceEndpoint *backup)
+{
+    std::string method_path = "/" + method->service()->name() + "/" + method->name();
+    EndpointList endpoints = ServiceDiscovery::getInstance().Lookup(method_path);
+    if (endpoints == nullptr)
+    {
+        return false;
+    }
+    std::vector<ServiceEndpoint> others;
+    for (const ServiceEndpoint &endpoint : *endpoints)
+    {
+        if (endpoint.m_host != primary.m_host && endpoint.m_state->m_breaker.Available())
+        {
+            others.push_back(endpoint);
+        }
+    }
+    if (others.empty())
+    {
+        return false;
+    }
+    size_t index = m_loadBalancer->Select(others);
+    if (index >= others.size())
+    {
+        return false;
+    }
+    *backup = others[index];
+    return true;
+}
+
+void MprpcChannel::CallMethod(const google::protobuf::MethodDescriptor *method, google::protobuf::RpcController *controller, const google::protobuf::Message *request, google::protobuf::Message *response, google::protobuf::Closure *done)
+{
+    std::string args_str;
+    if (!request->SerializeToString(&args_str))
     {
         // std::cout << "serialize request error!" << std::endl;
         controller->SetFailed("serialize request error!");
+        if (done != nullptr)
+            done->Run();
+        return;
+    }
+
+    // 响应缓存：命中时直接返回，不查服务端、不发请求
+    ResponseCache *cache = m_responseCache ? ResponseCache::ForMethod(method) : nullptr;
+    if (cache != nullptr && cache->Lookup(args_str, &t_recvBuffer))
+    {
+        if (!response->ParseFromString(t_recvBuffer))
+            controller->SetFailed("parse response error!");
+        if (done != nullptr)
+            done->Run();
+        return;
+    }
+
+    // 相同请求合并：幂等方法同一时刻的相同请求只发出一次
+    if (m_singleFlight && SingleFlightEnabled() && method->options().GetExtension(mprpc::idempotent))
+    {
+        CallCoalesced(method, controller, args_str, cache, response, done);
         return;
     }
+    Invoke(method, controller, args_str, cache, response, done);
+}
 
+// 合并调用中一个等待者的状态，由合并结果、截止时间定时器和取消处理共同持有，先到者决定结果
+// 发起者因自己的取消或截止时间结束时交给等待者的结果：与等待者无关，等待者各自重新发起
+static const char kFlightRetry[] = "\x01flight leader gave up";
+
+struct FlightWaiter
+{
+    google::protobuf::RpcController *m_controller;
+    google::protobuf::Message *m_response;
+    google::protobuf::Closure *m_done; // 异步等待者的 done，同步等待者为空
+    std::function<void()> m_retry;     // 异步等待者重新发起调用
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    bool m_finished = false;
+    std::string m_error;
+    std::string m_responseStr;
+
+    // 记录结果；已有结果时返回 false，之后的结果被忽略
+    bool Finish(const std::string &error, const std::string &response_str)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_finished)
+        {
+            return false;
+        }
+        m_finished = true;
+        m_error = error;
+        m_responseStr = response_str;
+        m_cond.notify_one();
+        return true;
+    }
+};
+
+// 异步等待者取得结果：注销取消处理后解析响应并执行 done，此后不再访问 controller
+static void CompleteFlightWaiter(const std::shared_ptr<FlightWaiter> &waiter, const std::string &error,
+                                 const std::string &response_str)
+{
+    if (!waiter->Finish(error, response_str))
+    {
+        return;
+    }
+    MprpcController *mprpcController = dynamic_cast<MprpcController *>(waiter->m_controller);
+    if (mprpcController != nullptr)
+        mprpcController->SetCancelHandler(nullptr);
+    if (error == kFlightRetry)
+    {
+        waiter->m_retry();
+        return;
+    }
+    ApplyFlightResult(error, response_str, waiter->m_controller, waiter->m_response);
+    waiter->m_done->Run();
+}
+
+/**
+ * @brief 合并同一时刻方法和请求都相同的调用
+ *
+ * 第一个调用照常发出，其余调用不发请求，等它结束后解析同一份响应；
+ * 等待者仍受自己的截止时间和取消约束：先于发起者超时或被取消时单独失败，发起者的调用继续进行，
+ * 其余等待者不受影响。发起者因自己的取消或截止时间失败时，结果不交给等待者，等待者重新合并发起。
+ * 异步等待者的 done 在发起者结束的线程或客户端 I/O 线程中执行。
+ */
+void MprpcChannel::CallCoalesced(const google::protobuf::MethodDescriptor *method,
+                                 google::protobuf::RpcController *controller, const std::string &args_str,
+                                 ResponseCache *cache, google::protobuf::Message *response,
+                                 google::protobuf::Closure *done)
+{
+    std::string key = method->full_name();
+    key.push_back('\0');
+    key += args_str;
+    SingleFlight &flight = SingleFlight::getInstance();
+
+    std::shared_ptr<FlightWaiter> waiter = std::make_shared<FlightWaiter>();
+    waiter->m_controller = controller;
+    waiter->m_response = response;
+    waiter->m_done = done;
+    SingleFlight::Callback onResult;
+    if (done != nullptr)
+    {
+        waiter->m_retry = [this, method, controller, args_str, cache, response, done]()
+        { CallCoalesced(method, controller, args_str, cache, response, done); };
+        onResult = [waiter](const std::string &error, const std::string &response_str)
+        { CompleteFlightWaiter(waiter, error, response_str); };
+    }
+    else
+    {
+        onResult = [waiter](const std::string &error, const std::string &response_str)
+        { waiter->Finish(error, response_str); };
+    }
+
+    bool leader = flight.Join(key, onResult);
+    if (leader && done != nullptr)
+    {
+        // 先把结果交给等待者，再执行自己的 done，之后 controller/response 可能被释放
+        FlightCall *call = new FlightCall{key, controller, response, done};
+        Invoke(method, controller, args_str, cache, response, google::protobuf::NewCallback(&FinishFlight, call));
+        return;
+    }
+    if (leader)
+    {
+        Invoke(method, controller, args_str, cache, response, nullptr);
+        FlightCall call{key, controller, response, nullptr};
+        FinishFlight(&call);
+        return;
+    }
+
+    // 等待者：登记自己的取消处理和截止时间。取消处理在持有 controller 的锁时执行，
+    // 异步等待者因此转到 I/O 线程中结束，不在当前栈上执行 done
+    Clock::time_point deadline = GetDeadline(controller);
+    MprpcController *mprpcController = dynamic_cast<MprpcController *>(controller);
+    bool canceled = false;
+    if (mprpcController != nullptr)
+    {
+        std::function<void()> handler;
+        if (done != nullptr)
+        {
+            handler = [waiter]()
+            {
+                RpcClient::getInstance().RunAfter(0, [waiter]()
+                                                  { CompleteFlightWaiter(waiter, "canceled", ""); });
+            };
+        }
+        else
+        {
+            handler = [waiter]()
+            { waiter->Finish("canceled", ""); };
+        }
+        canceled = !mprpcController->SetCancelHandler(handler);
+    }
+
+    if (done != nullptr)
+    {
+        if (canceled)
+        {
+            CompleteFlightWaiter(waiter, "canceled", "");
+        }
+        else if (deadline != kNoDeadline)
+        {
+            RpcClient::getInstance().RunAfter(TimeoutMs(deadline), [waiter]()
+                                              { CompleteFlightWaiter(waiter, "deadline exceeded", ""); });
+        }
+        return;
+    }
+
+    if (canceled)
+    {
+        waiter->Finish("canceled", "");
+    }
+    {
+        std::unique_lock<std::mutex> lock(waiter->m_mutex);
+        if (deadline == kNoDeadline)
+        {
+            waiter->m_cond.wait(lock, [&waiter]()
+                                { return waiter->m_finished; });
+        }
+        else if (!waiter->m_cond.wait_until(lock, deadline, [&waiter]()
+                                            { return waiter->m_finished; }))
+        {
+            waiter->m_finished = true;
+            waiter->m_error = "deadline exceeded";
+        }
+    }
+    // 不能持有 waiter 的锁注销：取消处理持有 controller 的锁时会获取 waiter 的锁
+    if (mprpcController != nullptr)
+        mprpcController->SetCancelHandler(nullptr);
+    if (waiter->m_error == kFlightRetry)
+    {
+        CallCoalesced(method, controller, args_str, cache, response, nullptr);
+        return;
+    }
+    ApplyFlightResult(waiter->m_error, waiter->m_responseStr, controller, response);
+}
+
+// 发起者的调用结束：结果序列化后交给等待者，异步调用随后执行它自己的 done 并释放 call
+void MprpcChannel::FinishFlight(FlightCall *call)
+{
+    const std::string &error = call->m_controller->ErrorText();
+    if (call->m_controller->Failed() && (error == "canceled" || error == "deadline exceeded"))
+    {
+        // 发起者自己放弃了调用，等待者的截止时间可能更宽松，让它们重新发起
+        SingleFlight::getInstance().Finish(call->m_key, kFlightRetry, "");
+    }
+    else if (call->m_controller->Failed())
+    {
+        SingleFlight::getInstance().Finish(call->m_key, error, "");
+    }
+    else
+    {
+        SingleFlight::getInstance().Finish(call->m_key, "", call->m_response->SerializeAsString());
+    }
+    if (call->m_done != nullptr)
+    {
+        call->m_done->Run();
+        delete call;
+    }
+}
+
+/**
+ * @brief 发出一次调用：选择服务端、组帧，按连接方式发送并解析响应
+ *
+ * args_str 为序列化后的请求；cache 非空时成功的响应写入缓存。
+ */
+void MprpcChannel::Invoke(const google::protobuf::MethodDescriptor *method, google::protobuf::RpcController *controller,
+                          const std::string &args_str, ResponseCache *cache, google::protobuf::Message *response,
+                          google::protobuf::Closure *done)
+{
+    std::string service_name = method->service()->name();
+    std::string method_name = method->name();
+    uint32_t args_size = args_str.size();
+
+    ServiceEndpoint endpoint;
+    if (!SelectEndpoint(method, controller, &endpoint))
+    {
+        // 异步调用出错同样要执行 done，调用方才能得知调用结束
+        if (done != nullptr)
+            done->Run();
+        return;
+    }
+    // 连接地址：服务端在本机时为 Unix 域套接字，否则为 ip:port
+    const std::string &host_data = endpoint.m_address;
+
+    // 幂等方法有多个服务端时做对冲：主请求超过对冲延迟仍未返回，再向另一个服务端发送备份请求
+    ServiceEndpoint backup;
+    bool hedged = method->options().GetExtension(mprpc::idempotent) && SelectBackup(method, endpoint, &backup);
+
+    // 只携带方法 ID，服务端直接查分发表，省去服务名/方法名的传输和字符串查找
     mprpc::RpcHeader rpcHeader;
-    rpcHeader.set_service_name(service_name);
-    rpcHeader.set_method_name(method_name);
+    rpcHeader.set_method_id(RpcMethodId(method->full_name()));
     rpcHeader.set_args_size(args_size);
+    // 异步调用和对冲调用经由客户端 I/O 线程，同样需要 request_id 来匹配响应
+    uint64_t request_id = (m_mode != kShortConnection || done != nullptr || hedged) ? ++g_requestId : 0;
+    rpcHeader.set_request_id(request_id);
+
+    // 截止时间：剩余时间随请求发给服务端，服务端据此丢弃排队中已超时的请求
+    Clock::time_point deadline = GetDeadline(controller);
+    if (deadline != kNoDeadline)
+    {
+        int64_t remaining = RemainingMs(deadline);
+        if (remaining == 0)
+        {
+            controller->SetFailed("deadline exceeded");
+            if (done != nullptr)
+                done->Run();
+            return;
+        }
+        rpcHeader.set_timeout_ms(remaining);
+    }
 
     uint32_t header_size = 0;
     std::string rpc_header_str;
@@ -45,11 +812,13 @@ void MprpcChannel::CallMethod(const google::protobuf::MethodDescriptor *method,
     {
         // std::cout << "serialize rpc header error!" << std::endl;
         controller->SetFailed("serialize rpc header error!");
+        if (done != nullptr)
+            done->Run();
         return;
     }
 
     std::string send_rpc_str;
-    send_rpc_str.insert(0, std::string((char *)&header_size, 4));
+    send_rpc_str.insert(0, std::string((char *)&header_size, kRpcHeaderLenBytes));
     send_rpc_str += rpc_header_str;
     send_rpc_str += args_str;
 
@@ -62,85 +831,465 @@ void MprpcChannel::CallMethod(const google::protobuf::MethodDescriptor *method,
     std::cout << "args_str: " << args_str << std::endl;             // 参数的大小（字节）
     std::cout << "==================================" << std::endl;
 
-    int clientfd = socket(AF_INET, SOCK_STREAM, 0);
-    if (clientfd == -1)
-    {
-        // std::cout << "create socket error! errno: " << errno << std::endl;
-        char errtxt[512] = {0};
-        sprintf(errtxt, "create socket error! errno: %d", errno);
-        controller->SetFailed(errtxt);
-        exit(EXIT_FAILURE);
-    }
-
     // std::string ip = MprpcApplication::getInstance().GetConfig().Load("rpcserverip");
     // uint16_t port = atoi(MprpcApplication::getInstance().GetConfig().Load("rpcserverport").c_str());、
 
-    ZkClient zkCli;
-    zkCli.Start();
+    // 经由客户端 I/O 线程发送的方式：异步调用和对冲调用使用
+    int64_t timeout_ms = TimeoutMs(deadline);
+    SendFunction transport = [&](RpcClient::ResponseCallback cb)
+    {
+        if (hedged)
+        {
+            SendHedged(endpoint, backup, LatencyTracker::ForMethod(method->full_name()),
+                       request_id, send_rpc_str, timeout_ms, std::move(cb));
+        }
+        else
+        {
+            SendTracked(endpoint, request_id, send_rpc_str, timeout_ms, std::move(cb));
+        }
+    };
+    // 取消时两路对冲请求都以 "canceled" 结束，对冲回调在后结束的一路上完成
+    std::string backup_host = hedged ? backup.m_address : "";
+    std::function<void()> cancel = [host_data, backup_host, request_id]()
+    {
+        RpcClient::getInstance().Cancel(host_data, request_id, "canceled");
+        if (!backup_host.empty())
+        {
+            RpcClient::getInstance().Cancel(backup_host, request_id, "canceled");
+        }
+    };
+    SendFunction send = [&](RpcClient::ResponseCallback cb)
+    {
+        SendCancelable(transport, controller, cancel, std::move(cb));
+    };
+
+    if (done != nullptr)
+    {
+        if (cache == nullptr)
+        {
+            CallAsync(send, controller, response, done);
+            return;
+        }
+        // 异步调用在 I/O 线程中收到成功的响应时写入缓存
+        SendFunction sendCached = [&](RpcClient::ResponseCallback cb)
+        {
+            send([cache, args_str, cb](const std::string &error, const mprpc::RpcHeader &rspHeader,
+                                       const char *payload, size_t payload_size)
+                 {
+                if (error.empty() && rspHeader.error_code() == mprpc::RPC_OK)
+                    cache->Insert(args_str, std::string(payload, payload_size));
+                cb(error, rspHeader, payload, payload_size); });
+        };
+        CallAsync(sendCached, controller, response, done);
+        return;
+    }
 
-    std::string method_path = "/" + service_name + "/" + method_name;
-    std::string host_data = zkCli.GetData(method_path.c_str());
-    if (host_data == "")
+    if (hedged)
     {
-        controller->SetFailed(method_path + " is not exist!!");
+        mprpc::RpcHeader rspHeader;
+        std::string &response_str = t_recvBuffer;
+        if (TransactAsync(send, controller, &rspHeader, &response_str))
+        {
+            if (ParseResponse(rspHeader, response_str, controller, response) && cache != nullptr)
+                cache->Insert(args_str, response_str);
+        }
         return;
     }
-    int idx = host_data.find(":");
-    if (idx == -1)
+
+    OutstandingGuard outstanding(endpoint.m_state);
+
+    if (m_mode != kShortConnection)
     {
-        controller->SetFailed(method_path + " address is invalid!!");
+        mprpc::RpcHeader rspHeader;
+        std::string &response_str = t_recvBuffer;
+        bool local = false;
+        if (!Transact(host_data, request_id, send_rpc_str, controller, &rspHeader, &response_str, &local))
+        {
+            // 本地原因（如连接池借出数达到上限）的失败与服务端无关，不计入它的健康统计
+            if (!local)
+                outstanding.Finish(controller->ErrorText(), nullptr);
+            return;
+        }
+        outstanding.Finish("", &rspHeader);
+        if (ParseResponse(rspHeader, response_str, controller, response) && cache != nullptr)
+            cache->Insert(args_str, response_str);
         return;
     }
-    std::string ip = host_data.substr(0, idx);
-    uint16_t port = atoi(host_data.substr(idx + 1, host_data.size() - idx).c_str());
 
-    struct sockaddr_in server_addr;
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(port);
-    server_addr.sin_addr.s_addr = inet_addr(ip.c_str());
+    struct sockaddr_storage server_addr;
+    socklen_t addr_len = ResolveRpcAddress(host_data, &server_addr);
+    if (addr_len == 0)
+    {
+        controller->SetFailed("invalid provider address: " + host_data);
+        return;
+    }
 
-    if (connect(clientfd, (struct sockaddr *)&server_addr, sizeof(server_addr)))
+    // 本地创建套接字失败与服务端无关，不计入它的健康统计
+    int clientfd = socket(server_addr.ss_family, SOCK_STREAM, 0);
+    if (clientfd == -1)
     {
-        // std::cout << "connect error! errno: " << errno << std::endl;
-        close(clientfd);
+        // std::cout << "create socket error! errno: " << errno << std::endl;
         char errtxt[512] = {0};
-        sprintf(errtxt, "connect socket error! errno: %d", errno);
+        sprintf(errtxt, "create socket error! errno: %d", errno);
         controller->SetFailed(errtxt);
+        return;
+    }
 
-        exit(EXIT_FAILURE);
+    // 有截止时间时连接、发送和接收都以非阻塞方式进行，超时即返回
+    if (!ConnectWithDeadline(clientfd, (struct sockaddr *)&server_addr, addr_len, deadline))
+    {
+        // std::cout << "connect error! errno: " << errno << std::endl;
+        // 连接失败计入服务端的健康统计，连续失败的服务端会被摘除，之后的调用转向其他服务端
+        int err = errno;
+        close(clientfd);
+        if (err == ETIMEDOUT)
+        {
+            controller->SetFailed("deadline exceeded");
+        }
+        else
+        {
+            char errtxt[512] = {0};
+            sprintf(errtxt, "connect socket error! errno: %d", err);
+            controller->SetFailed(errtxt);
+        }
+        outstanding.Finish(controller->ErrorText(), nullptr);
+        return;
     }
 
-    if (send(clientfd, send_rpc_str.c_str(), send_rpc_str.size(), 0) == -1)
+    // 取消时关闭连接的读写唤醒阻塞的 send/recv，服务端看到连接断开也会取消这次调用
+    if (!WatchCancel(controller, clientfd))
+    {
+        close(clientfd);
+        return;
+    }
+    if (!SendAll(clientfd, send_rpc_str.c_str(), send_rpc_str.size(), deadline))
     {
         // std::cout << "send error! errno: " << errno << std::endl;
+        if (!UnwatchCancel(controller))
+            controller->SetFailed(SocketError("send socket"));
+        outstanding.Finish(controller->ErrorText(), nullptr);
         close(clientfd);
-        char errtxt[512] = {0};
-        sprintf(errtxt, "send socket error! errno: %d", errno);
-        controller->SetFailed(errtxt);
         return;
     }
 
-    char recv_buf[1024] = {0};
-    int recv_size = 0;
-    if ((recv_size = recv(clientfd, recv_buf, 1024, 0)) == -1)
+    // 按长度前缀读取完整的响应帧，响应再大也不会被截断
+    mprpc::RpcHeader rspHeader;
+    std::string &response_str = t_recvBuffer;
+    int ret = RecvFrame(clientfd, &rspHeader, &response_str, deadline);
+    bool canceled = UnwatchCancel(controller);
+    if (ret != 1 || canceled)
     {
         // std::cout << "recv error! errno: " << errno << std::endl;
+        if (!canceled)
+            controller->SetFailed(SocketError("recv socket"));
+        outstanding.Finish(controller->ErrorText(), nullptr);
         close(clientfd);
-        char errtxt[512] = {0};
-        sprintf(errtxt, "recv socket error! errno: %d", errno);
-        controller->SetFailed(errtxt);
         return;
     }
-    // std::string response_str(recv_buf, 0, recv_size);
-    // if (!response->ParseFromString(response_str))
-    if (!response->ParseFromArray(recv_buf, recv_size))
+    close(clientfd);
+    outstanding.Finish("", &rspHeader);
+    if (ParseResponse(rspHeader, response_str, controller, response) && cache != nullptr)
+        cache->Insert(args_str, response_str);
+}
+
+/**
+ * @brief 异步调用：请求交给客户端 I/O 线程发送后立即返回
+ *
+ * 响应在 I/O 线程中解析到 response，随后在该线程中执行 done->Run()，
+ * 因此 done 中不应有耗时操作；调用方需保证 controller/response/done 在此之前有效。
+ */
+void MprpcChannel::CallAsync(const SendFunction &send, google::protobuf::RpcController *controller,
+                             google::protobuf::Message *response, google::protobuf::Closure *done)
+{
+    send([controller, response, done](const std::string &error, const mprpc::RpcHeader &rspHeader,
+                                      const char *payload, size_t payload_size)
+         {
+        if (!error.empty())
+        {
+            if (controller != nullptr)
+                controller->SetFailed(error);
+        }
+        else if (rspHeader.error_code() != mprpc::RPC_OK)
+        {
+            if (controller != nullptr)
+                controller->SetFailed(rspHeader.error_text());
+        }
+        else if (!response->ParseFromArray(payload, payload_size))
+        {
+            if (controller != nullptr)
+                controller->SetFailed("parse response error!");
+        }
+        done->Run(); });
+}
+
+/**
+ * @brief 在长连接上发送一帧并读取 request_id 匹配的响应帧
+ *
+ * 流水线模式经由客户端 I/O 线程（TransactAsync）；其余情况连接从进程级连接池借出，同一地址的连接在所有 channel 的多次调用间复用，
+ * 免去每次调用的 TCP 握手和 TIME_WAIT；不同线程的调用各自借出连接，互不阻塞。
+ * 读写出错的连接状态未知，不再放回池中。
+ * 复用的连接可能已被服务端关闭，此时换一条连接重试一次。
+ * 有截止时间时读写以非阻塞方式进行，超时的连接上可能还有未读的响应，同样不再放回池中。
+ * 调用被取消时关闭连接的读写，阻塞的读写随即返回，服务端看到连接断开后取消这次调用。
+ */
+bool MprpcChannel::Transact(const std::string &host, uint64_t request_id, const std::string &send_rpc_str,
+                            google::protobuf::RpcController *controller, mprpc::RpcHeader *rspHeader, std::string *response_str,
+                            bool *local)
+{
+    *local = false;
+    if (m_mode == kPipelined)
+    {
+        int64_t timeout_ms = TimeoutMs(GetDeadline(controller));
+        SendFunction transport = [&](RpcClient::ResponseCallback cb)
+        {
+            RpcClient::getInstance().Send(host, request_id, send_rpc_str, std::move(cb), timeout_ms);
+        };
+        std::function<void()> cancel = [host, request_id]()
+        {
+            RpcClient::getInstance().Cancel(host, request_id, "canceled");
+        };
+        SendFunction send = [&](RpcClient::ResponseCallback cb)
+        {
+            SendCancelable(transport, controller, cancel, std::move(cb));
+        };
+        return TransactAsync(send, controller, rspHeader, response_str);
+    }
+
+    ConnectionPool &pool = ConnectionPool::getInstance();
+    Clock::time_point deadline = GetDeadline(controller);
+    std::string errtxt;
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        bool reused = false;
+        int clientfd = pool.Acquire(host, deadline, &reused, local, &errtxt);
+        if (clientfd == -1)
+        {
+            controller->SetFailed(errtxt);
+            return false;
+        }
+
+        if (!WatchCancel(controller, clientfd))
+        {
+            pool.Release(host, clientfd, false);
+            return false;
+        }
+        int ret = -1;
+        if (SendAll(clientfd, send_rpc_str.c_str(), send_rpc_str.size(), deadline))
+        {
+            do
+            {
+                ret = RecvFrame(clientfd, rspHeader, response_str, deadline);
+            } while (ret == 1 && rspHeader->request_id() != request_id);
+        }
+        // 已被取消的连接读写都已关闭，不再放回池中，也不重试
+        if (UnwatchCancel(controller))
+        {
+            pool.Release(host, clientfd, true);
+            return false;
+        }
+        if (ret == 1)
+        {
+            pool.Release(host, clientfd, false);
+            return true;
+        }
+
+        // 连接已失效，关闭后视情况重试
+        errtxt = SocketError("rpc connection");
+        pool.Release(host, clientfd, true);
+        if (!(reused && ret == 0))
+        {
+            break;
+        }
+    }
+
+    controller->SetFailed(errtxt);
+    return false;
+}
+
+/**
+ * @brief 经由客户端 I/O 线程发送，阻塞等待响应帧（流水线模式和同步的对冲调用）
+ *
+ * 请求由 send 交给 I/O 线程写入该服务端的唯一连接，不等前一个响应即可发出下一个，
+ * 多个线程的调用共用一条连接；响应按 request_id 在未完成请求表中匹配，可以乱序返回。
+ * 响应数据在 I/O 线程中拷贝到调用方的缓冲区，解析仍在调用方线程进行，不占用 I/O 线程。
+ */
+bool MprpcChannel::TransactAsync(const SendFunction &send, google::protobuf::RpcController *controller,
+                                 mprpc::RpcHeader *rspHeader, std::string *response_str)
+{
+    struct Waiter
+    {
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+        bool m_finished = false;
+        std::string m_error;
+    };
+    // 等待方和 I/O 线程中的回调共同持有，后结束的一方释放
+    std::shared_ptr<Waiter> waiter = std::make_shared<Waiter>();
+
+    send([waiter, rspHeader, response_str](const std::string &error, const mprpc::RpcHeader &header,
+                                           const char *payload, size_t payload_size)
+         {
+        std::lock_guard<std::mutex> lock(waiter->m_mutex);
+        if (error.empty())
+        {
+            *rspHeader = header;
+            response_str->assign(payload, payload_size);
+        }
+        waiter->m_error = error;
+        waiter->m_finished = true;
+        waiter->m_cond.notify_one(); });
+
+    std::unique_lock<std::mutex> lock(waiter->m_mutex);
+    waiter->m_cond.wait(lock, [&waiter]()
+                        { return waiter->m_finished; });
+    if (!waiter->m_error.empty())
+    {
+        controller->SetFailed(waiter->m_error);
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------- 批量调用 ----------------------------
+void MprpcBatch::Add(const google::protobuf::MethodDescriptor *method,
+                     google::protobuf::RpcController *controller,
+                     const google::protobuf::Message *request,
+                     google::protobuf::Message *response)
+{
+    m_items.push_back({method, controller, request, response});
+}
+
+/**
+ * @brief 发送批量调用
+ *
+ * 所有请求打包成一个 RPC_FRAME_BATCH 帧，一次系统调用发出，服务端一次性返回所有响应，
+ * 省去每个小请求各自的组帧、系统调用和往返。批量调用总是走长连接，短连接模式的 channel 也从连接池借出连接。
+ * 服务端按第一项的方法选出，其余各项的方法也必须由它提供。
+ */
+void MprpcChannel::CallBatch(MprpcBatch *batch, google::protobuf::RpcController *controller)
+{
+    if (batch->m_items.empty())
     {
-        // std::cout << "parse error! response_str: " << recv_buf << std::endl;
-        close(clientfd);
-        char errtxt[512] = {0};
-        int ret = snprintf(errtxt, sizeof(errtxt), "parse error! errno: %s", recv_buf);
-        controller->SetFailed(errtxt);
         return;
     }
-    close(clientfd);
-}
\ No newline at end of file
+
+    ServiceEndpoint endpoint;
+    if (!SelectEndpoint(batch->m_items[0].m_method, controller, &endpoint))
+    {
+        return;
+    }
+    const std::string &host = endpoint.m_host;
+
+    mprpc::RpcBatch requests;
+    for (const MprpcBatch::Item &item : batch->m_items)
+    {
+        EndpointList endpoints = LookupEndpoints(item.m_method, controller);
+        if (endpoints == nullptr)
+        {
+            return;
+        }
+        bool served = false;
+        for (const ServiceEndpoint &candidate : *endpoints)
+        {
+            served = served || candidate.m_host == host;
+        }
+        if (!served)
+        {
+            controller->SetFailed("batch methods are served by different providers!");
+            return;
+        }
+
+        mprpc::RpcBatchItem *requestItem = requests.add_items();
+        if (!item.m_request->SerializeToString(requestItem->mutable_args()))
+        {
+            controller->SetFailed("serialize request error!");
+            return;
+        }
+        requestItem->mutable_header()->set_method_id(RpcMethodId(item.m_method->full_name()));
+        requestItem->mutable_header()->set_args_size(requestItem->args().size());
+    }
+
+    std::string args_str;
+    if (!requests.SerializeToString(&args_str))
+    {
+        controller->SetFailed("serialize batch error!");
+        return;
+    }
+
+    mprpc::RpcHeader rpcHeader;
+    uint64_t request_id = ++g_requestId;
+    rpcHeader.set_request_id(request_id);
+    rpcHeader.set_frame_type(mprpc::RPC_FRAME_BATCH);
+    rpcHeader.set_args_size(args_str.size());
+    Clock::time_point deadline = GetDeadline(controller);
+    if (deadline != kNoDeadline)
+    {
+        if (RemainingMs(deadline) == 0)
+        {
+            controller->SetFailed("deadline exceeded");
+            return;
+        }
+        rpcHeader.set_timeout_ms(RemainingMs(deadline));
+    }
+    std::string rpc_header_str;
+    if (!rpcHeader.SerializeToString(&rpc_header_str))
+    {
+        controller->SetFailed("serialize rpc header error!");
+        return;
+    }
+    uint32_t header_size = rpc_header_str.size();
+    std::string send_rpc_str((char *)&header_size, kRpcHeaderLenBytes);
+    send_rpc_str += rpc_header_str;
+    send_rpc_str += args_str;
+
+    OutstandingGuard outstanding(endpoint.m_state);
+    mprpc::RpcHeader rspHeader;
+    std::string &response_str = t_recvBuffer;
+    bool local = false;
+    if (!Transact(endpoint.m_address, request_id, send_rpc_str, controller, &rspHeader, &response_str, &local))
+    {
+        if (!local)
+            outstanding.Finish(controller->ErrorText(), nullptr);
+        return;
+    }
+    outstanding.Finish("", &rspHeader);
+    if (rspHeader.error_code() != mprpc::RPC_OK)
+    {
+        controller->SetFailed(rspHeader.error_text());
+        return;
+    }
+
+    mprpc::RpcBatch responses;
+    if (!responses.ParseFromString(response_str) || responses.items_size() != (int)batch->m_items.size())
+    {
+        controller->SetFailed("parse batch response error!");
+        return;
+    }
+    for (int i = 0; i < responses.items_size(); ++i)
+    {
+        const MprpcBatch::Item &item = batch->m_items[i];
+        const mprpc::RpcBatchItem &responseItem = responses.items(i);
+        bool failed = true;
+        std::string error_text;
+        if (responseItem.header().error_code() != mprpc::RPC_OK)
+        {
+            error_text = responseItem.header().error_text();
+        }
+        else if (!item.m_response->ParseFromString(responseItem.args()))
+        {
+            error_text = "parse response error!";
+        }
+        else
+        {
+            failed = false;
+        }
+        if (failed)
+        {
+            if (item.m_controller != nullptr)
+            {
+                item.m_controller->SetFailed(error_text);
+            }
+            controller->SetFailed("some calls in batch failed!");
+        }
+    }
+}
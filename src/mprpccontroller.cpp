@@ -4,12 +4,18 @@ MprpcController::MprpcController()
 {
     m_failed = false;
     m_errText = "";
+    m_hasDeadline = false;
+    m_canceled = false;
 }
 
 void MprpcController::Reset()
 {
     m_failed = false;
     m_errText = "";
+    m_hasDeadline = false;
+    std::lock_guard<std::recursive_mutex> lock(m_cancelMutex);
+    m_canceled = false;
+    m_cancelHandler = nullptr;
 }
 
 bool MprpcController::Failed() const
@@ -28,15 +34,102 @@ void MprpcController::SetFailed(const std::string &reason)
     m_errText = reason;
 }
 
+/**
+ * @brief 取消调用
+ *
+ * 客户端的中止处理在持锁状态下执行，保证与调用结束时的清除互斥；
+ * 回调在释放锁之后执行，回调中可能结束调用并释放 controller，之后不再访问成员。
+ */
 void MprpcController::StartCancel()
 {
+    std::vector<google::protobuf::Closure *> callbacks;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_cancelMutex);
+        if (m_canceled)
+        {
+            return;
+        }
+        m_canceled = true;
+        if (m_cancelHandler)
+        {
+            std::function<void()> handler = m_cancelHandler;
+            handler();
+        }
+        callbacks.swap(m_cancelCallbacks);
+    }
+    for (google::protobuf::Closure *callback : callbacks)
+    {
+        callback->Run();
+    }
 }
 
 bool MprpcController::IsCanceled() const
 {
-    return false;
+    std::lock_guard<std::recursive_mutex> lock(m_cancelMutex);
+    return m_canceled;
 }
 
 void MprpcController::NotifyOnCancel(google::protobuf::Closure *callback)
 {
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_cancelMutex);
+        if (!m_canceled)
+        {
+            m_cancelCallbacks.push_back(callback);
+            return;
+        }
+    }
+    callback->Run();
+}
+
+bool MprpcController::SetCancelHandler(std::function<void()> handler)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_cancelMutex);
+    m_cancelHandler = std::move(handler);
+    return !m_canceled;
+}
+
+void MprpcController::RunCancelCallbacks()
+{
+    std::vector<google::protobuf::Closure *> callbacks;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_cancelMutex);
+        callbacks.swap(m_cancelCallbacks);
+    }
+    for (google::protobuf::Closure *callback : callbacks)
+    {
+        callback->Run();
+    }
+}
+
+void MprpcController::SetTimeout(int64_t timeout_ms)
+{
+    SetDeadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms));
+}
+
+void MprpcController::SetDeadline(std::chrono::steady_clock::time_point deadline)
+{
+    m_hasDeadline = true;
+    m_deadline = deadline;
+}
+
+bool MprpcController::HasDeadline() const
+{
+    return m_hasDeadline;
+}
+
+std::chrono::steady_clock::time_point MprpcController::Deadline() const
+{
+    return m_deadline;
+}
+
+int64_t MprpcController::RemainingMs() const
+{
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(m_deadline - std::chrono::steady_clock::now());
+    return remaining.count() > 0 ? remaining.count() : 0;
+}
+
+bool MprpcController::DeadlineExceeded() const
+{
+    return m_hasDeadline && std::chrono::steady_clock::now() >= m_deadline;
 }
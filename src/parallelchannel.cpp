@@ -0,0 +1,189 @@
+#include "parallelchannel.h"
+#include "servicediscovery.h"
+
+void ParallelChannel::AddCall(google::protobuf::RpcChannel *channel, const google::protobuf::MethodDescriptor *method,
+                              const google::protobuf::Message *request)
+{
+    m_calls.push_back({channel, method, request});
+}
+
+// 每个服务端一个固定选中它的 channel，服务端在调用前下线时该子调用失败
+size_t ParallelChannel::AddAllProviders(const google::protobuf::MethodDescriptor *method,
+                                        const google::protobuf::Message *request,
+                                        google::protobuf::RpcController *controller)
+{
+    std::string method_path = "/" + method->service()->name() + "/" + method->name();
+    EndpointList endpoints = ServiceDiscovery::getInstance().Lookup(method_path);
+    if (endpoints == nullptr || endpoints->empty())
+    {
+        if (controller != nullptr)
+            controller->SetFailed(method_path + " is not exist!!");
+        return 0;
+    }
+    for (const ServiceEndpoint &endpoint : *endpoints)
+    {
+        m_balancers.emplace_back(new PinnedLoadBalancer(endpoint.m_host));
+        m_channels.emplace_back(new MprpcChannel(MprpcChannel::kPipelined, m_balancers.back().get()));
+        // 每个服务端都要真正收到请求：相同请求不能合并成一个，也不能由缓存应答
+        m_channels.back()->SetSingleFlight(false);
+        m_channels.back()->SetResponseCache(false);
+        AddCall(m_channels.back().get(), method, request);
+    }
+    return endpoints->size();
+}
+
+void ParallelChannel::Clear()
+{
+    m_calls.clear();
+    m_channels.clear();
+    m_balancers.clear();
+}
+
+/**
+ * @brief 发起所有子调用
+ *
+ * 子调用全部以异步方式发出，done 在客户端 I/O 线程中执行，结果在那里合并；
+ * 子调用同步出错时 done 在本线程执行，所以发起期间不持锁。
+ * 调用可能在全部子调用发出之前就已结束（例如失败太多），done 因此可能在 Call 返回前执行，
+ * ParallelChannel 本身需要在 Call 返回前保持有效。
+ */
+void ParallelChannel::Call(google::protobuf::RpcController *controller, const Merger &merger, size_t quorum,
+                           google::protobuf::Closure *done)
+{
+    size_t total = m_calls.size();
+    if (quorum == 0)
+    {
+        quorum = total;
+    }
+    if (total == 0 || quorum > total)
+    {
+        if (total != 0 && controller != nullptr)
+            controller->SetFailed("parallel call quorum " + std::to_string(quorum) + " exceeds call count " +
+                                  std::to_string(total) + "!");
+        if (done != nullptr)
+            done->Run();
+        return;
+    }
+
+    MprpcController *parent = dynamic_cast<MprpcController *>(controller);
+    CallStatePtr state = std::make_shared<CallState>();
+    state->m_merger = merger;
+    state->m_controller = controller;
+    state->m_done = done;
+    state->m_quorum = quorum;
+    state->m_completed.assign(total, false);
+    for (const SubCall &call : m_calls)
+    {
+        std::unique_ptr<MprpcController> subController(new MprpcController);
+        if (parent != nullptr && parent->HasDeadline())
+        {
+            subController->SetDeadline(parent->Deadline());
+        }
+        state->m_controllers.push_back(std::move(subController));
+        const google::protobuf::Message *prototype =
+            google::protobuf::MessageFactory::generated_factory()->GetPrototype(call.m_method->output_type());
+        state->m_responses.emplace_back(prototype->New());
+    }
+
+    // 取消整个调用即取消所有子调用；已被取消时子调用发出后立即失败
+    if (parent != nullptr)
+    {
+        std::function<void()> handler = [state]()
+        {
+            std::lock_guard<std::mutex> lock(state->m_mutex);
+            if (!state->m_finished)
+                CancelPending(state.get());
+        };
+        if (!parent->SetCancelHandler(handler))
+        {
+            handler();
+        }
+    }
+
+    for (size_t i = 0; i < total; ++i)
+    {
+        const SubCall &call = m_calls[i];
+        call.m_channel->CallMethod(call.m_method, state->m_controllers[i].get(), call.m_request,
+                                   state->m_responses[i].get(),
+                                   google::protobuf::NewCallback(&ParallelChannel::OnCallDone, state, i));
+    }
+
+    if (done == nullptr)
+    {
+        std::unique_lock<std::mutex> lock(state->m_mutex);
+        state->m_cond.wait(lock, [&state]()
+                           { return state->m_finished; });
+        lock.unlock();
+        if (parent != nullptr)
+            parent->SetCancelHandler(nullptr);
+    }
+}
+
+/**
+ * @brief 子调用结束
+ *
+ * 成功数达到 quorum，或剩余的子调用全部成功也达不到 quorum 时整个调用结束，
+ * 其余仍在进行的子调用被取消，它们之后的回调只记录完成，不再合并。
+ */
+void ParallelChannel::OnCallDone(CallStatePtr state, size_t index)
+{
+    std::unique_lock<std::mutex> lock(state->m_mutex);
+    state->m_completed[index] = true;
+    if (state->m_finished)
+    {
+        return;
+    }
+
+    MprpcController *subController = state->m_controllers[index].get();
+    if (!subController->Failed())
+    {
+        state->m_merger(index, *state->m_responses[index]);
+        state->m_succeeded++;
+    }
+    else
+    {
+        if (state->m_failed == 0)
+            state->m_firstError = subController->ErrorText();
+        state->m_failed++;
+    }
+
+    size_t total = state->m_controllers.size();
+    bool succeeded = state->m_succeeded >= state->m_quorum;
+    if (!succeeded && total - state->m_failed >= state->m_quorum)
+    {
+        return;
+    }
+
+    state->m_finished = true;
+    if (!succeeded && state->m_controller != nullptr)
+    {
+        state->m_controller->SetFailed("parallel call failed: " + std::to_string(state->m_succeeded) + " of " +
+                                       std::to_string(state->m_quorum) + " required calls succeeded, first error: " +
+                                       state->m_firstError);
+    }
+    CancelPending(state.get());
+
+    google::protobuf::Closure *done = state->m_done;
+    if (done == nullptr)
+    {
+        state->m_cond.notify_one();
+        return;
+    }
+    lock.unlock();
+    MprpcController *parent = dynamic_cast<MprpcController *>(state->m_controller);
+    if (parent != nullptr)
+        parent->SetCancelHandler(nullptr);
+    done->Run();
+}
+
+// 取消尚未结束的子调用（包括还没发出的），需持有 m_mutex；取消只是排队，不会在本线程回调
+void ParallelChannel::CancelPending(CallState *state)
+{
+    for (size_t i = 0; i < state->m_controllers.size(); ++i)
+    {
+        if (!state->m_completed[i])
+        {
+            state->m_controllers[i]->StartCancel();
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#include "responsecache.h"
+#include "mprpcapplication.h"
+#include "mprpcoptions.pb.h"
+#include <iostream>
+#include <memory>
+
+// 未配置 rpccachebytes 时每个方法的缓存上限
+static const size_t kDefaultCacheBytes = 16 * 1024 * 1024;
+
+/**
+ * @brief 获取方法的缓存，首次访问时按配置创建
+ *
+ * 每次调用都要经过这里，先查线程内的映射，只有每个线程第一次调用某方法时才访问加锁的全局表。
+ */
+ResponseCache *ResponseCache::ForMethod(const google::protobuf::MethodDescriptor *method)
+{
+    static thread_local std::unordered_map<const google::protobuf::MethodDescriptor *, ResponseCache *> t_caches;
+    auto it = t_caches.find(method);
+    if (it != t_caches.end())
+    {
+        return it->second;
+    }
+
+    static std::mutex mutex;
+    static std::unordered_map<const google::protobuf::MethodDescriptor *, std::unique_ptr<ResponseCache>> caches;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = caches.find(method);
+    if (found == caches.end())
+    {
+        MprpcConfig &config = MprpcApplication::getInstance().GetConfig();
+        int64_t ttl_ms = atoll(config.Load("rpccachettlms." + method->full_name()).c_str());
+        std::string bytes = config.Load("rpccachebytes." + method->full_name());
+        std::unique_ptr<ResponseCache> cache;
+        if (ttl_ms > 0 && !method->options().GetExtension(mprpc::idempotent))
+        {
+            std::cout << method->full_name() << " is not idempotent, response cache disabled" << std::endl;
+        }
+        else if (ttl_ms > 0)
+        {
+            cache.reset(new ResponseCache(ttl_ms, bytes.empty() ? kDefaultCacheBytes : atoll(bytes.c_str())));
+        }
+        found = caches.emplace(method, std::move(cache)).first;
+    }
+    t_caches[method] = found->second.get();
+    return found->second.get();
+}
+
+ResponseCache::ResponseCache(int64_t ttl_ms, size_t max_bytes)
+    : m_ttl(ttl_ms), m_shardBytes(max_bytes / kShardCount)
+{
+}
+
+ResponseCache::Shard &ResponseCache::ShardFor(const std::string &key)
+{
+    return m_shards[std::hash<std::string>()(key) % kShardCount];
+}
+
+void ResponseCache::Erase(Shard &shard, std::list<Entry>::iterator it)
+{
+    shard.m_bytes -= it->m_key.size() + it->m_value.size();
+    shard.m_index.erase(it->m_key);
+    shard.m_lru.erase(it);
+}
+
+bool ResponseCache::Lookup(const std::string &request_str, std::string *response_str)
+{
+    Shard &shard = ShardFor(request_str);
+    std::lock_guard<std::mutex> lock(shard.m_mutex);
+    auto it = shard.m_index.find(request_str);
+    if (it == shard.m_index.end())
+    {
+        return false;
+    }
+    if (it->second->m_expire <= Clock::now())
+    {
+        Erase(shard, it->second);
+        return false;
+    }
+    shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, it->second);
+    *response_str = it->second->m_value;
+    return true;
+}
+
+// 插入或更新响应，超出容量时从最久未使用的一端淘汰；单条超过分片容量的响应不缓存
+void ResponseCache::Insert(const std::string &request_str, const std::string &response_str)
+{
+    size_t bytes = request_str.size() + response_str.size();
+    if (bytes > m_shardBytes)
+    {
+        return;
+    }
+    Shard &shard = ShardFor(request_str);
+    std::lock_guard<std::mutex> lock(shard.m_mutex);
+    auto it = shard.m_index.find(request_str);
+    if (it != shard.m_index.end())
+    {
+        Erase(shard, it->second);
+    }
+    while (shard.m_bytes + bytes > m_shardBytes)
+    {
+        Erase(shard, std::prev(shard.m_lru.end()));
+    }
+    shard.m_lru.push_front({request_str, response_str, Clock::now() + m_ttl});
+    shard.m_index.emplace(request_str, shard.m_lru.begin());
+    shard.m_bytes += bytes;
+}
@@ -0,0 +1,51 @@
+#include "rpcaddress.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+bool IsUnixAddress(const std::string &address)
+{
+    return address.compare(0, sizeof(kUnixAddressPrefix) - 1, kUnixAddressPrefix) == 0;
+}
+
+socklen_t ResolveRpcAddress(const std::string &address, struct sockaddr_storage *addr)
+{
+    memset(addr, 0, sizeof(*addr));
+    if (IsUnixAddress(address))
+    {
+        std::string path = address.substr(sizeof(kUnixAddressPrefix) - 1);
+        struct sockaddr_un *un = reinterpret_cast<struct sockaddr_un *>(addr);
+        if (path.empty() || path.size() >= sizeof(un->sun_path))
+        {
+            return 0;
+        }
+        un->sun_family = AF_UNIX;
+        memcpy(un->sun_path, path.c_str(), path.size() + 1);
+        return sizeof(struct sockaddr_un);
+    }
+
+    int idx = address.find(":");
+    if (idx == -1)
+    {
+        return 0;
+    }
+    struct sockaddr_in *in = reinterpret_cast<struct sockaddr_in *>(addr);
+    in->sin_family = AF_INET;
+    in->sin_port = htons(atoi(address.substr(idx + 1).c_str()));
+    in->sin_addr.s_addr = inet_addr(address.substr(0, idx).c_str());
+    return sizeof(struct sockaddr_in);
+}
+
+const std::string &LocalHostName()
+{
+    static std::string name = []()
+    {
+        char buf[256] = {0};
+        gethostname(buf, sizeof(buf) - 1);
+        return std::string(buf);
+    }();
+    return name;
+}
@@ -0,0 +1,343 @@
+#include "rpcclient.h"
+#include "rpcprotocol.h"
+#include "rpcaddress.h"
+#include <errno.h>
+#include <iostream>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// 建立连接的超时时间（秒），超时后该连接上等待发送的调用全部失败
+static const double kConnectTimeoutSeconds = 3.0;
+
+RpcClient::RpcClient() : m_loop(m_loopThread.startLoop())
+{
+}
+
+RpcClient &RpcClient::getInstance()
+{
+    // 故意不析构：I/O 线程和其中的连接一直存活到进程退出，避免退出时的析构顺序问题
+    static RpcClient *client = new RpcClient();
+    return *client;
+}
+
+void RpcClient::Send(const std::string &host, uint64_t request_id, const std::string &frame, ResponseCallback cb,
+                     int64_t timeout_ms)
+{
+    m_loop->runInLoop([this, host, request_id, frame, cb, timeout_ms]()
+                      { SendInLoop(host, request_id, frame, cb, timeout_ms); });
+}
+
+void RpcClient::SendInLoop(const std::string &host, uint64_t request_id, const std::string &frame, const ResponseCallback &cb,
+                           int64_t timeout_ms)
+{
+    Session *session = GetSession(host);
+    PendingCall &call = session->m_pending[request_id];
+    call.m_cb = cb;
+    if (timeout_ms > 0)
+    {
+        call.m_hasTimer = true;
+        call.m_timer = m_loop->runAfter(timeout_ms / 1000.0, [this, session, request_id]()
+                                        { OnTimeout(session, request_id); });
+    }
+    if (session->m_conn)
+    {
+        session->m_conn->send(frame);
+        return;
+    }
+
+    // 连接尚未建立：先排队，连上后统一发送
+    session->m_waiting.emplace_back(request_id, frame);
+    if (!session->m_connecting)
+    {
+        Connect(session);
+    }
+}
+
+// 获取到 host 的会话，不存在时创建；会话一旦创建就一直保留，连接断开后下次发送时重连
+RpcClient::Session *RpcClient::GetSession(const std::string &host)
+{
+    std::unique_ptr<Session> &session = m_sessions[host];
+    if (!session)
+    {
+        session.reset(new Session);
+        session->m_host = host;
+    }
+    return session.get();
+}
+
+/**
+ * @brief 为一次建连创建新的 TcpClient，旧的延迟销毁
+ *
+ * 停止过的 TcpClient 不能再次 connect：Connector::stop 不会取消已排定的重试定时器，
+ * 定时器到期时会与新的连接过程同时进行；连接断开后 Connector 的状态也不会复位。
+ * 旧 TcpClient 上迟到的连接回调（seq 已过期）直接关闭连接，不影响会话。
+ */
+void RpcClient::ResetClient(Session *session, uint64_t seq)
+{
+    if (session->m_client)
+    {
+        std::shared_ptr<muduo::net::TcpClient> old(std::move(session->m_client));
+        m_loop->queueInLoop([old]() {});
+    }
+
+    int idx = session->m_host.find(":");
+    std::string ip = session->m_host.substr(0, idx);
+    uint16_t port = atoi(session->m_host.substr(idx + 1).c_str());
+    session->m_client.reset(new muduo::net::TcpClient(m_loop, muduo::net::InetAddress(ip, port),
+                                                      "RpcClient-" + session->m_host));
+    session->m_client->setConnectionCallback([this, session, seq](const muduo::net::TcpConnectionPtr &conn)
+                                             {
+        if (session->m_connectSeq != seq)
+        {
+            if (conn->connected())
+                conn->forceClose();
+            return;
+        }
+        OnConnection(session, conn); });
+    session->m_client->setMessageCallback([this, session](const muduo::net::TcpConnectionPtr &conn,
+                                                          muduo::net::Buffer *buffer, muduo::Timestamp)
+                                          { OnMessage(session, conn, buffer); });
+}
+
+/**
+ * @brief 发起连接
+ *
+ * muduo 的 Connector 连接失败后会一直退避重试，这里加一个超时：
+ * 超时仍未连上就停止重试，让排队中的调用失败，下次发送时再重新连接。
+ */
+void RpcClient::Connect(Session *session)
+{
+    if (IsUnixAddress(session->m_host))
+    {
+        ConnectUnix(session);
+        return;
+    }
+    session->m_connecting = true;
+    uint64_t seq = ++session->m_connectSeq;
+    ResetClient(session, seq);
+    session->m_client->connect();
+    m_loop->runAfter(kConnectTimeoutSeconds, [this, session, seq]()
+                     {
+        if (session->m_connecting && session->m_connectSeq == seq)
+        {
+            session->m_client->stop();
+            session->m_connecting = false;
+            FailAll(session, "connect " + session->m_host + " timeout!");
+        } });
+}
+
+/**
+ * @brief 连接本机服务端的 Unix 域套接字
+ *
+ * muduo 的 TcpClient 只支持网络地址，这里自己建连，再用 fd 构造 TcpConnection，之后的收发与 TCP 连接相同。
+ * 本机连接要么立即成功要么立即失败（服务端未监听或积压队列已满），不需要超时定时器。
+ */
+void RpcClient::ConnectUnix(Session *session)
+{
+    struct sockaddr_storage addr;
+    socklen_t len = ResolveRpcAddress(session->m_host, &addr);
+    int fd = len == 0 ? -1 : socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd == -1 || connect(fd, (struct sockaddr *)&addr, len) != 0)
+    {
+        // 与 TCP 连接失败一样异步回调，调用方可能正在 I/O 线程中发送；期间的发送继续排队
+        std::string error = "connect " + session->m_host + " error! errno: " + std::to_string(errno);
+        if (fd != -1)
+            close(fd);
+        session->m_connecting = true;
+        m_loop->queueInLoop([this, session, error]()
+                            {
+            session->m_connecting = false;
+            FailAll(session, error); });
+        return;
+    }
+
+    muduo::net::TcpConnectionPtr conn = std::make_shared<muduo::net::TcpConnection>(
+        m_loop, "RpcClient-" + session->m_host + "#" + std::to_string(++session->m_connectSeq), fd,
+        muduo::net::InetAddress(), muduo::net::InetAddress());
+    conn->setConnectionCallback([this, session](const muduo::net::TcpConnectionPtr &c)
+                                { OnConnection(session, c); });
+    conn->setMessageCallback([this, session](const muduo::net::TcpConnectionPtr &c,
+                                             muduo::net::Buffer *buffer, muduo::Timestamp)
+                             { OnMessage(session, c, buffer); });
+    // 与 TcpClient 相同：断开后延迟销毁，当前仍在该连接的回调中
+    conn->setCloseCallback([this](const muduo::net::TcpConnectionPtr &c)
+                           { m_loop->queueInLoop([c]()
+                                                 { c->connectDestroyed(); }); });
+    conn->connectEstablished();
+}
+
+void RpcClient::OnConnection(Session *session, const muduo::net::TcpConnectionPtr &conn)
+{
+    if (conn->connected())
+    {
+        session->m_connecting = false;
+        session->m_conn = conn;
+        for (auto &waiting : session->m_waiting)
+        {
+            conn->send(waiting.second);
+        }
+        session->m_waiting.clear();
+    }
+    else
+    {
+        // 连接断开，上面所有未完成的调用都不会再有响应
+        session->m_conn.reset();
+        FailAll(session, "connection to " + session->m_host + " closed!");
+    }
+}
+
+/**
+ * @brief 解析响应帧，与服务端的解帧方式相同：一次回调中可能有半帧，也可能有多帧
+ */
+void RpcClient::OnMessage(Session *session, const muduo::net::TcpConnectionPtr &conn, muduo::net::Buffer *buffer)
+{
+    while (buffer->readableBytes() >= kRpcHeaderLenBytes)
+    {
+        uint32_t header_size = 0;
+        memcpy(&header_size, buffer->peek(), kRpcHeaderLenBytes);
+        if (header_size > kRpcMaxHeaderSize)
+        {
+            std::cout << "rpc response header size invalid: " << header_size << std::endl;
+            buffer->retrieveAll();
+            conn->forceClose();
+            return;
+        }
+        if (buffer->readableBytes() < kRpcHeaderLenBytes + header_size)
+        {
+            break;
+        }
+
+        mprpc::RpcHeader rspHeader;
+        if (!rspHeader.ParseFromArray(buffer->peek() + kRpcHeaderLenBytes, header_size) ||
+            rspHeader.args_size() > kRpcMaxArgsSize)
+        {
+            std::cout << "rpc response header parse error" << std::endl;
+            buffer->retrieveAll();
+            conn->forceClose();
+            return;
+        }
+        size_t frame_size = kRpcHeaderLenBytes + header_size + rspHeader.args_size();
+        if (buffer->readableBytes() < frame_size)
+        {
+            break;
+        }
+
+        // 找不到对应请求的响应（调用方已放弃）直接丢弃
+        auto it = session->m_pending.find(rspHeader.request_id());
+        if (it != session->m_pending.end())
+        {
+            PendingCall call = std::move(it->second);
+            session->m_pending.erase(it);
+            if (call.m_hasTimer)
+            {
+                m_loop->cancel(call.m_timer);
+            }
+            call.m_cb("", rspHeader, buffer->peek() + kRpcHeaderLenBytes + header_size, rspHeader.args_size());
+        }
+        buffer->retrieve(frame_size);
+    }
+}
+
+void RpcClient::Cancel(const std::string &host, uint64_t request_id, const std::string &error)
+{
+    // 总是排队执行：调用方可能持有 controller 的取消锁，不能在当前栈上回调
+    m_loop->queueInLoop([this, host, request_id, error]()
+                        {
+        auto it = m_sessions.find(host);
+        ResponseCallback cb;
+        if (it != m_sessions.end() && RemovePending(it->second.get(), request_id, &cb) && !error.empty())
+        {
+            mprpc::RpcHeader emptyHeader;
+            cb(error, emptyHeader, nullptr, 0);
+        } });
+}
+
+void RpcClient::RunAfter(int64_t delay_ms, std::function<void()> cb)
+{
+    m_loop->runAfter(delay_ms / 1000.0, std::move(cb));
+}
+
+/**
+ * @brief 从未完成表中移除请求，取消其超时定时器
+ *
+ * 尚未发出的帧一并从待发送队列中移除；已发出的请求向服务端发送取消帧，让服务端停止执行，
+ * 之后到达的响应找不到对应项，会被直接丢弃。
+ * @return 请求仍未完成时返回 true，回调通过 cb 取出（可以为空）
+ */
+bool RpcClient::RemovePending(Session *session, uint64_t request_id, ResponseCallback *cb)
+{
+    auto it = session->m_pending.find(request_id);
+    if (it == session->m_pending.end())
+    {
+        return false;
+    }
+    if (it->second.m_hasTimer)
+    {
+        m_loop->cancel(it->second.m_timer);
+    }
+    if (cb != nullptr)
+    {
+        *cb = std::move(it->second.m_cb);
+    }
+    session->m_pending.erase(it);
+    for (auto wit = session->m_waiting.begin(); wit != session->m_waiting.end(); ++wit)
+    {
+        if (wit->first == request_id)
+        {
+            session->m_waiting.erase(wit);
+            return true;
+        }
+    }
+    if (session->m_conn)
+    {
+        SendCancelFrame(session->m_conn, request_id);
+    }
+    return true;
+}
+
+// 取消帧只有头部，没有数据，服务端不回复
+void RpcClient::SendCancelFrame(const muduo::net::TcpConnectionPtr &conn, uint64_t request_id)
+{
+    mprpc::RpcHeader rpcHeader;
+    rpcHeader.set_request_id(request_id);
+    rpcHeader.set_frame_type(mprpc::RPC_FRAME_CANCEL);
+    std::string header_str;
+    rpcHeader.SerializeToString(&header_str);
+    uint32_t header_size = header_str.size();
+
+    std::string frame;
+    frame.reserve(kRpcHeaderLenBytes + header_size);
+    frame.append(reinterpret_cast<const char *>(&header_size), kRpcHeaderLenBytes);
+    frame += header_str;
+    conn->send(frame);
+}
+
+// 请求超时：移除并回调失败
+void RpcClient::OnTimeout(Session *session, uint64_t request_id)
+{
+    ResponseCallback cb;
+    if (RemovePending(session, request_id, &cb))
+    {
+        mprpc::RpcHeader emptyHeader;
+        cb("deadline exceeded", emptyHeader, nullptr, 0);
+    }
+}
+
+// 让会话上所有等待发送和等待响应的调用失败
+void RpcClient::FailAll(Session *session, const std::string &error)
+{
+    std::unordered_map<uint64_t, PendingCall> pending;
+    pending.swap(session->m_pending);
+    session->m_waiting.clear();
+
+    mprpc::RpcHeader emptyHeader;
+    for (auto &call : pending)
+    {
+        if (call.second.m_hasTimer)
+        {
+            m_loop->cancel(call.second.m_timer);
+        }
+        call.second.m_cb(error, emptyHeader, nullptr, 0);
+    }
+}
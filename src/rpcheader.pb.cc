@@ -25,7 +25,13 @@ PROTOBUF_CONSTEXPR RpcHeader::RpcHeader(
     ::_pbi::ConstantInitialized): _impl_{
     /*decltype(_impl_.service_name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
   , /*decltype(_impl_.method_name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.error_text_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.request_id_)*/uint64_t{0u}
   , /*decltype(_impl_.args_size_)*/0u
+  , /*decltype(_impl_.error_code_)*/0
+  , /*decltype(_impl_.method_id_)*/0u
+  , /*decltype(_impl_.frame_type_)*/0
+  , /*decltype(_impl_.timeout_ms_)*/0u
   , /*decltype(_impl_._cached_size_)*/{}} {}
 struct RpcHeaderDefaultTypeInternal {
   PROTOBUF_CONSTEXPR RpcHeaderDefaultTypeInternal()
@@ -36,9 +42,36 @@ struct RpcHeaderDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 RpcHeaderDefaultTypeInternal _RpcHeader_default_instance_;
+PROTOBUF_CONSTEXPR RpcBatchItem::RpcBatchItem(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.args_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.header_)*/nullptr
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct RpcBatchItemDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR RpcBatchItemDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~RpcBatchItemDefaultTypeInternal() {}
+  union {
+    RpcBatchItem _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 RpcBatchItemDefaultTypeInternal _RpcBatchItem_default_instance_;
+PROTOBUF_CONSTEXPR RpcBatch::RpcBatch(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.items_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct RpcBatchDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR RpcBatchDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~RpcBatchDefaultTypeInternal() {}
+  union {
+    RpcBatch _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 RpcBatchDefaultTypeInternal _RpcBatch_default_instance_;
 }  // namespace mprpc
-static ::_pb::Metadata file_level_metadata_rpcheader_2eproto[1];
-static constexpr ::_pb::EnumDescriptor const** file_level_enum_descriptors_rpcheader_2eproto = nullptr;
+static ::_pb::Metadata file_level_metadata_rpcheader_2eproto[3];
+static const ::_pb::EnumDescriptor* file_level_enum_descriptors_rpcheader_2eproto[2];
 static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_rpcheader_2eproto = nullptr;
 
 const uint32_t TableStruct_rpcheader_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
@@ -51,25 +84,64 @@ const uint32_t TableStruct_rpcheader_2eproto::offsets[] PROTOBUF_SECTION_VARIABL
   PROTOBUF_FIELD_OFFSET(::mprpc::RpcHeader, _impl_.service_name_),
   PROTOBUF_FIELD_OFFSET(::mprpc::RpcHeader, _impl_.method_name_),
   PROTOBUF_FIELD_OFFSET(::mprpc::RpcHeader, _impl_.args_size_),
+  PROTOBUF_FIELD_OFFSET(::mprpc::RpcHeader, _impl_.request_id_),
+  PROTOBUF_FIELD_OFFSET(::mprpc::RpcHeader, _impl_.error_code_),
+  PROTOBUF_FIELD_OFFSET(::mprpc::RpcHeader, _impl_.error_text_),
+  PROTOBUF_FIELD_OFFSET(::mprpc::RpcHeader, _impl_.method_id_),
+  PROTOBUF_FIELD_OFFSET(::mprpc::RpcHeader, _impl_.frame_type_),
+  PROTOBUF_FIELD_OFFSET(::mprpc::RpcHeader, _impl_.timeout_ms_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::mprpc::RpcBatchItem, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::mprpc::RpcBatchItem, _impl_.header_),
+  PROTOBUF_FIELD_OFFSET(::mprpc::RpcBatchItem, _impl_.args_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::mprpc::RpcBatch, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::mprpc::RpcBatch, _impl_.items_),
 };
 static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
   { 0, -1, -1, sizeof(::mprpc::RpcHeader)},
+  { 15, -1, -1, sizeof(::mprpc::RpcBatchItem)},
+  { 23, -1, -1, sizeof(::mprpc::RpcBatch)},
 };
 
 static const ::_pb::Message* const file_default_instances[] = {
   &::mprpc::_RpcHeader_default_instance_._instance,
+  &::mprpc::_RpcBatchItem_default_instance_._instance,
+  &::mprpc::_RpcBatch_default_instance_._instance,
 };
 
 const char descriptor_table_protodef_rpcheader_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
-  "\n\017rpcheader.proto\022\005mprpc\"I\n\tRpcHeader\022\024\n"
-  "\014service_name\030\001 \001(\014\022\023\n\013method_name\030\002 \001(\014"
-  "\022\021\n\targs_size\030\003 \001(\rb\006proto3"
+  "\n\017rpcheader.proto\022\005mprpc\"\352\001\n\tRpcHeader\022\024"
+  "\n\014service_name\030\001 \001(\014\022\023\n\013method_name\030\002 \001("
+  "\014\022\021\n\targs_size\030\003 \001(\r\022\022\n\nrequest_id\030\004 \001(\004"
+  "\022\'\n\nerror_code\030\005 \001(\0162\023.mprpc.RpcErrorCod"
+  "e\022\022\n\nerror_text\030\006 \001(\014\022\021\n\tmethod_id\030\007 \001(\r"
+  "\022\'\n\nframe_type\030\010 \001(\0162\023.mprpc.RpcFrameTyp"
+  "e\022\022\n\ntimeout_ms\030\t \001(\r\">\n\014RpcBatchItem\022 \n"
+  "\006header\030\001 \001(\0132\020.mprpc.RpcHeader\022\014\n\004args\030"
+  "\002 \001(\014\".\n\010RpcBatch\022\"\n\005items\030\001 \003(\0132\023.mprpc"
+  ".RpcBatchItem*\303\001\n\014RpcErrorCode\022\n\n\006RPC_OK"
+  "\020\000\022\031\n\025RPC_SERVICE_NOT_FOUND\020\001\022\030\n\024RPC_MET"
+  "HOD_NOT_FOUND\020\002\022\033\n\027RPC_REQUEST_PARSE_ERR"
+  "OR\020\003\022\023\n\017RPC_SERVER_BUSY\020\004\022\023\n\017RPC_CALL_FA"
+  "ILED\020\005\022\031\n\025RPC_DEADLINE_EXCEEDED\020\006\022\020\n\014RPC"
+  "_CANCELED\020\007*O\n\014RpcFrameType\022\024\n\020RPC_FRAME"
+  "_SINGLE\020\000\022\023\n\017RPC_FRAME_BATCH\020\001\022\024\n\020RPC_FR"
+  "AME_CANCEL\020\002b\006proto3"
   ;
 static ::_pbi::once_flag descriptor_table_rpcheader_2eproto_once;
 const ::_pbi::DescriptorTable descriptor_table_rpcheader_2eproto = {
-    false, false, 107, descriptor_table_protodef_rpcheader_2eproto,
+    false, false, 660, descriptor_table_protodef_rpcheader_2eproto,
     "rpcheader.proto",
-    &descriptor_table_rpcheader_2eproto_once, nullptr, 0, 1,
+    &descriptor_table_rpcheader_2eproto_once, nullptr, 0, 3,
     schemas, file_default_instances, TableStruct_rpcheader_2eproto::offsets,
     file_level_metadata_rpcheader_2eproto, file_level_enum_descriptors_rpcheader_2eproto,
     file_level_service_descriptors_rpcheader_2eproto,
@@ -81,6 +153,41 @@ PROTOBUF_ATTRIBUTE_WEAK const ::_pbi::DescriptorTable* descriptor_table_rpcheade
 // Force running AddDescriptors() at dynamic initialization time.
 PROTOBUF_ATTRIBUTE_INIT_PRIORITY2 static ::_pbi::AddDescriptorsRunner dynamic_init_dummy_rpcheader_2eproto(&descriptor_table_rpcheader_2eproto);
 namespace mprpc {
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* RpcErrorCode_descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_rpcheader_2eproto);
+  return file_level_enum_descriptors_rpcheader_2eproto[0];
+}
+bool RpcErrorCode_IsValid(int value) {
+  switch (value) {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+    case 4:
+    case 5:
+    case 6:
+    case 7:
+      return true;
+    default:
+      return false;
+  }
+}
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* RpcFrameType_descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_rpcheader_2eproto);
+  return file_level_enum_descriptors_rpcheader_2eproto[1];
+}
+bool RpcFrameType_IsValid(int value) {
+  switch (value) {
+    case 0:
+    case 1:
+    case 2:
+      return true;
+    default:
+      return false;
+  }
+}
+
 
 // ===================================================================
 
@@ -100,7 +207,13 @@ RpcHeader::RpcHeader(const RpcHeader& from)
   new (&_impl_) Impl_{
       decltype(_impl_.service_name_){}
     , decltype(_impl_.method_name_){}
+    , decltype(_impl_.error_text_){}
+    , decltype(_impl_.request_id_){}
     , decltype(_impl_.args_size_){}
+    , decltype(_impl_.error_code_){}
+    , decltype(_impl_.method_id_){}
+    , decltype(_impl_.frame_type_){}
+    , decltype(_impl_.timeout_ms_){}
     , /*decltype(_impl_._cached_size_)*/{}};
 
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
@@ -120,7 +233,17 @@ RpcHeader::RpcHeader(const RpcHeader& from)
     _this->_impl_.method_name_.Set(from._internal_method_name(), 
       _this->GetArenaForAllocation());
   }
-  _this->_impl_.args_size_ = from._impl_.args_size_;
+  _impl_.error_text_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.error_text_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_error_text().empty()) {
+    _this->_impl_.error_text_.Set(from._internal_error_text(), 
+      _this->GetArenaForAllocation());
+  }
+  ::memcpy(&_impl_.request_id_, &from._impl_.request_id_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.timeout_ms_) -
+    reinterpret_cast<char*>(&_impl_.request_id_)) + sizeof(_impl_.timeout_ms_));
   // @@protoc_insertion_point(copy_constructor:mprpc.RpcHeader)
 }
 
@@ -131,7 +254,13 @@ inline void RpcHeader::SharedCtor(
   new (&_impl_) Impl_{
       decltype(_impl_.service_name_){}
     , decltype(_impl_.method_name_){}
+    , decltype(_impl_.error_text_){}
+    , decltype(_impl_.request_id_){uint64_t{0u}}
     , decltype(_impl_.args_size_){0u}
+    , decltype(_impl_.error_code_){0}
+    , decltype(_impl_.method_id_){0u}
+    , decltype(_impl_.frame_type_){0}
+    , decltype(_impl_.timeout_ms_){0u}
     , /*decltype(_impl_._cached_size_)*/{}
   };
   _impl_.service_name_.InitDefault();
@@ -142,6 +271,10 @@ inline void RpcHeader::SharedCtor(
   #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
     _impl_.method_name_.Set("", GetArenaForAllocation());
   #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.error_text_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.error_text_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
 }
 
 RpcHeader::~RpcHeader() {
@@ -157,6 +290,7 @@ inline void RpcHeader::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
   _impl_.service_name_.Destroy();
   _impl_.method_name_.Destroy();
+  _impl_.error_text_.Destroy();
 }
 
 void RpcHeader::SetCachedSize(int size) const {
@@ -171,7 +305,10 @@ void RpcHeader::Clear() {
 
   _impl_.service_name_.ClearToEmpty();
   _impl_.method_name_.ClearToEmpty();
-  _impl_.args_size_ = 0u;
+  _impl_.error_text_.ClearToEmpty();
+  ::memset(&_impl_.request_id_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.timeout_ms_) -
+      reinterpret_cast<char*>(&_impl_.request_id_)) + sizeof(_impl_.timeout_ms_));
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
 
@@ -207,6 +344,57 @@ const char* RpcHeader::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx
         } else
           goto handle_unusual;
         continue;
+      // uint64 request_id = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
+          _impl_.request_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .mprpc.RpcErrorCode error_code = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_error_code(static_cast<::mprpc::RpcErrorCode>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // bytes error_text = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 50)) {
+          auto str = _internal_mutable_error_text();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 method_id = 7;
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 56)) {
+          _impl_.method_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .mprpc.RpcFrameType frame_type = 8;
+      case 8:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 64)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_frame_type(static_cast<::mprpc::RpcFrameType>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 timeout_ms = 9;
+      case 9:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 72)) {
+          _impl_.timeout_ms_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -254,6 +442,44 @@ uint8_t* RpcHeader::_InternalSerialize(
     target = ::_pbi::WireFormatLite::WriteUInt32ToArray(3, this->_internal_args_size(), target);
   }
 
+  // uint64 request_id = 4;
+  if (this->_internal_request_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(4, this->_internal_request_id(), target);
+  }
+
+  // .mprpc.RpcErrorCode error_code = 5;
+  if (this->_internal_error_code() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      5, this->_internal_error_code(), target);
+  }
+
+  // bytes error_text = 6;
+  if (!this->_internal_error_text().empty()) {
+    target = stream->WriteBytesMaybeAliased(
+        6, this->_internal_error_text(), target);
+  }
+
+  // uint32 method_id = 7;
+  if (this->_internal_method_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(7, this->_internal_method_id(), target);
+  }
+
+  // .mprpc.RpcFrameType frame_type = 8;
+  if (this->_internal_frame_type() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      8, this->_internal_frame_type(), target);
+  }
+
+  // uint32 timeout_ms = 9;
+  if (this->_internal_timeout_ms() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(9, this->_internal_timeout_ms(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
@@ -284,11 +510,45 @@ size_t RpcHeader::ByteSizeLong() const {
         this->_internal_method_name());
   }
 
+  // bytes error_text = 6;
+  if (!this->_internal_error_text().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+        this->_internal_error_text());
+  }
+
+  // uint64 request_id = 4;
+  if (this->_internal_request_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_request_id());
+  }
+
   // uint32 args_size = 3;
   if (this->_internal_args_size() != 0) {
     total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_args_size());
   }
 
+  // .mprpc.RpcErrorCode error_code = 5;
+  if (this->_internal_error_code() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_error_code());
+  }
+
+  // uint32 method_id = 7;
+  if (this->_internal_method_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_method_id());
+  }
+
+  // .mprpc.RpcFrameType frame_type = 8;
+  if (this->_internal_frame_type() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_frame_type());
+  }
+
+  // uint32 timeout_ms = 9;
+  if (this->_internal_timeout_ms() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_timeout_ms());
+  }
+
   return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
@@ -313,9 +573,27 @@ void RpcHeader::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROT
   if (!from._internal_method_name().empty()) {
     _this->_internal_set_method_name(from._internal_method_name());
   }
+  if (!from._internal_error_text().empty()) {
+    _this->_internal_set_error_text(from._internal_error_text());
+  }
+  if (from._internal_request_id() != 0) {
+    _this->_internal_set_request_id(from._internal_request_id());
+  }
   if (from._internal_args_size() != 0) {
     _this->_internal_set_args_size(from._internal_args_size());
   }
+  if (from._internal_error_code() != 0) {
+    _this->_internal_set_error_code(from._internal_error_code());
+  }
+  if (from._internal_method_id() != 0) {
+    _this->_internal_set_method_id(from._internal_method_id());
+  }
+  if (from._internal_frame_type() != 0) {
+    _this->_internal_set_frame_type(from._internal_frame_type());
+  }
+  if (from._internal_timeout_ms() != 0) {
+    _this->_internal_set_timeout_ms(from._internal_timeout_ms());
+  }
   _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
@@ -343,7 +621,16 @@ void RpcHeader::InternalSwap(RpcHeader* other) {
       &_impl_.method_name_, lhs_arena,
       &other->_impl_.method_name_, rhs_arena
   );
-  swap(_impl_.args_size_, other->_impl_.args_size_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.error_text_, lhs_arena,
+      &other->_impl_.error_text_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(RpcHeader, _impl_.timeout_ms_)
+      + sizeof(RpcHeader::_impl_.timeout_ms_)
+      - PROTOBUF_FIELD_OFFSET(RpcHeader, _impl_.request_id_)>(
+          reinterpret_cast<char*>(&_impl_.request_id_),
+          reinterpret_cast<char*>(&other->_impl_.request_id_));
 }
 
 ::PROTOBUF_NAMESPACE_ID::Metadata RpcHeader::GetMetadata() const {
@@ -352,6 +639,431 @@ void RpcHeader::InternalSwap(RpcHeader* other) {
       file_level_metadata_rpcheader_2eproto[0]);
 }
 
+// ===================================================================
+
+class RpcBatchItem::_Internal {
+ public:
+  static const ::mprpc::RpcHeader& header(const RpcBatchItem* msg);
+};
+
+const ::mprpc::RpcHeader&
+RpcBatchItem::_Internal::header(const RpcBatchItem* msg) {
+  return *msg->_impl_.header_;
+}
+RpcBatchItem::RpcBatchItem(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:mprpc.RpcBatchItem)
+}
+RpcBatchItem::RpcBatchItem(const RpcBatchItem& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  RpcBatchItem* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.args_){}
+    , decltype(_impl_.header_){nullptr}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.args_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.args_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_args().empty()) {
+    _this->_impl_.args_.Set(from._internal_args(), 
+      _this->GetArenaForAllocation());
+  }
+  if (from._internal_has_header()) {
+    _this->_impl_.header_ = new ::mprpc::RpcHeader(*from._impl_.header_);
+  }
+  // @@protoc_insertion_point(copy_constructor:mprpc.RpcBatchItem)
+}
+
+inline void RpcBatchItem::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.args_){}
+    , decltype(_impl_.header_){nullptr}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.args_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.args_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+RpcBatchItem::~RpcBatchItem() {
+  // @@protoc_insertion_point(destructor:mprpc.RpcBatchItem)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void RpcBatchItem::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.args_.Destroy();
+  if (this != internal_default_instance()) delete _impl_.header_;
+}
+
+void RpcBatchItem::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void RpcBatchItem::Clear() {
+// @@protoc_insertion_point(message_clear_start:mprpc.RpcBatchItem)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.args_.ClearToEmpty();
+  if (GetArenaForAllocation() == nullptr && _impl_.header_ != nullptr) {
+    delete _impl_.header_;
+  }
+  _impl_.header_ = nullptr;
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* RpcBatchItem::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // .mprpc.RpcHeader header = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          ptr = ctx->ParseMessage(_internal_mutable_header(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bytes args = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          auto str = _internal_mutable_args();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* RpcBatchItem::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:mprpc.RpcBatchItem)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // .mprpc.RpcHeader header = 1;
+  if (this->_internal_has_header()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(1, _Internal::header(this),
+        _Internal::header(this).GetCachedSize(), target, stream);
+  }
+
+  // bytes args = 2;
+  if (!this->_internal_args().empty()) {
+    target = stream->WriteBytesMaybeAliased(
+        2, this->_internal_args(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:mprpc.RpcBatchItem)
+  return target;
+}
+
+size_t RpcBatchItem::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:mprpc.RpcBatchItem)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // bytes args = 2;
+  if (!this->_internal_args().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+        this->_internal_args());
+  }
+
+  // .mprpc.RpcHeader header = 1;
+  if (this->_internal_has_header()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+        *_impl_.header_);
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData RpcBatchItem::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    RpcBatchItem::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*RpcBatchItem::GetClassData() const { return &_class_data_; }
+
+
+void RpcBatchItem::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<RpcBatchItem*>(&to_msg);
+  auto& from = static_cast<const RpcBatchItem&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:mprpc.RpcBatchItem)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_args().empty()) {
+    _this->_internal_set_args(from._internal_args());
+  }
+  if (from._internal_has_header()) {
+    _this->_internal_mutable_header()->::mprpc::RpcHeader::MergeFrom(
+        from._internal_header());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void RpcBatchItem::CopyFrom(const RpcBatchItem& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:mprpc.RpcBatchItem)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool RpcBatchItem::IsInitialized() const {
+  return true;
+}
+
+void RpcBatchItem::InternalSwap(RpcBatchItem* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.args_, lhs_arena,
+      &other->_impl_.args_, rhs_arena
+  );
+  swap(_impl_.header_, other->_impl_.header_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata RpcBatchItem::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_rpcheader_2eproto_getter, &descriptor_table_rpcheader_2eproto_once,
+      file_level_metadata_rpcheader_2eproto[1]);
+}
+
+// ===================================================================
+
+class RpcBatch::_Internal {
+ public:
+};
+
+RpcBatch::RpcBatch(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:mprpc.RpcBatch)
+}
+RpcBatch::RpcBatch(const RpcBatch& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  RpcBatch* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.items_){from._impl_.items_}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  // @@protoc_insertion_point(copy_constructor:mprpc.RpcBatch)
+}
+
+inline void RpcBatch::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.items_){arena}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+RpcBatch::~RpcBatch() {
+  // @@protoc_insertion_point(destructor:mprpc.RpcBatch)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void RpcBatch::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.items_.~RepeatedPtrField();
+}
+
+void RpcBatch::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void RpcBatch::Clear() {
+// @@protoc_insertion_point(message_clear_start:mprpc.RpcBatch)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.items_.Clear();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* RpcBatch::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // repeated .mprpc.RpcBatchItem items = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_items(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<10>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* RpcBatch::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:mprpc.RpcBatch)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // repeated .mprpc.RpcBatchItem items = 1;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_items_size()); i < n; i++) {
+    const auto& repfield = this->_internal_items(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(1, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:mprpc.RpcBatch)
+  return target;
+}
+
+size_t RpcBatch::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:mprpc.RpcBatch)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated .mprpc.RpcBatchItem items = 1;
+  total_size += 1UL * this->_internal_items_size();
+  for (const auto& msg : this->_impl_.items_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData RpcBatch::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    RpcBatch::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*RpcBatch::GetClassData() const { return &_class_data_; }
+
+
+void RpcBatch::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<RpcBatch*>(&to_msg);
+  auto& from = static_cast<const RpcBatch&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:mprpc.RpcBatch)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.items_.MergeFrom(from._impl_.items_);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void RpcBatch::CopyFrom(const RpcBatch& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:mprpc.RpcBatch)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool RpcBatch::IsInitialized() const {
+  return true;
+}
+
+void RpcBatch::InternalSwap(RpcBatch* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.items_.InternalSwap(&other->_impl_.items_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata RpcBatch::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_rpcheader_2eproto_getter, &descriptor_table_rpcheader_2eproto_once,
+      file_level_metadata_rpcheader_2eproto[2]);
+}
+
 // @@protoc_insertion_point(namespace_scope)
 }  // namespace mprpc
 PROTOBUF_NAMESPACE_OPEN
@@ -359,6 +1071,14 @@ template<> PROTOBUF_NOINLINE ::mprpc::RpcHeader*
 Arena::CreateMaybeMessage< ::mprpc::RpcHeader >(Arena* arena) {
   return Arena::CreateMessageInternal< ::mprpc::RpcHeader >(arena);
 }
+template<> PROTOBUF_NOINLINE ::mprpc::RpcBatchItem*
+Arena::CreateMaybeMessage< ::mprpc::RpcBatchItem >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::mprpc::RpcBatchItem >(arena);
+}
+template<> PROTOBUF_NOINLINE ::mprpc::RpcBatch*
+Arena::CreateMaybeMessage< ::mprpc::RpcBatch >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::mprpc::RpcBatch >(arena);
+}
 PROTOBUF_NAMESPACE_CLOSE
 
 // @@protoc_insertion_point(global_scope)
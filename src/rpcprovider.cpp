@@ -4,6 +4,71 @@
 #include <functional>
 #include "rpcheader.pb.h"
 #include "zookeeperutil.h"
+#include "threadpool.h"
+#include "rpcprotocol.h"
+#include "rpcaddress.h"
+#include "unixacceptor.h"
+#include <string.h>
+#include <vector>
+#include <boost/any.hpp>
+
+// 每个 Arena 自带的初始内存块大小，Reset 后保留，常见的小请求不再触发 malloc
+static const size_t kArenaInitialBlockSize = 8 * 1024;
+// 每个线程最多缓存的空闲 Arena 数量
+static const size_t kMaxCachedArenas = 16;
+// 未配置时的默认 I/O 线程数和业务队列长度
+static const int kDefaultIoThreads = 4;
+static const size_t kDefaultWorkerQueueSize = 10000;
+static const size_t kDefaultHighWaterMark = 64 * 1024 * 1024;
+
+// ---------------------------- 请求内存池 ----------------------------
+/**
+ * 请求/响应消息及其内部的字符串、repeated 字段都分配在 Arena 上，
+ * 调用结束后 Reset 一次性释放，用户提供的初始内存块在 Reset 后保留复用。
+ */
+struct RpcProvider::RpcArena
+{
+    RpcArena() : m_initialBlock(new char[kArenaInitialBlockSize]), m_arena(Options(m_initialBlock.get())) {}
+
+    static google::protobuf::ArenaOptions Options(char *block)
+    {
+        google::protobuf::ArenaOptions options;
+        options.initial_block = block;
+        options.initial_block_size = kArenaInitialBlockSize;
+        return options;
+    }
+
+    std::unique_ptr<char[]> m_initialBlock; // 必须先于 m_arena 构造、后于其析构
+    google::protobuf::Arena m_arena;
+};
+
+// 每个 IO 线程缓存自己的空闲 Arena，获取/归还都无需加锁
+static thread_local std::vector<std::unique_ptr<RpcProvider::RpcArena>> t_arenaCache;
+
+RpcProvider::RpcArena *RpcProvider::AcquireArena()
+{
+    if (!t_arenaCache.empty())
+    {
+        RpcArena *rpcArena = t_arenaCache.back().release();
+        t_arenaCache.pop_back();
+        return rpcArena;
+    }
+    return new RpcArena;
+}
+
+void RpcProvider::ReleaseArena(RpcArena *rpcArena)
+{
+    rpcArena->m_arena.Reset(); // 释放本次调用的所有消息，保留初始块
+    if (t_arenaCache.size() < kMaxCachedArenas)
+    {
+        t_arenaCache.emplace_back(rpcArena);
+    }
+    else
+    {
+        delete rpcArena;
+    }
+}
+
 // ---------------------------- 服务注册方法 ----------------------------
 /**
  * @brief 注册服务到 RPC 框架
@@ -30,6 +95,7 @@ void RpcProvider::NotifyService(::google::protobuf::Service *service)
         const google::protobuf::MethodDescriptor *pmethodDesc = pserviceDesc->method(i);
         std::string method_name = pmethodDesc->name();
         service_info.m_methodMap.insert({method_name, pmethodDesc});
+        AddMethodId(RpcMethodId(pmethodDesc->full_name()), service, pmethodDesc);
 
         std::cout << "method_name: " << method_name << std::endl;
     }
@@ -37,6 +103,72 @@ void RpcProvider::NotifyService(::google::protobuf::Service *service)
     m_serviceMap.insert({service_name, service_info});
 }
 
+/**
+ * @brief 把方法 ID 加入分发表
+ *
+ * 分发表是开放寻址的扁平数组，容量为 2 的幂且至少是方法数的两倍，
+ * 按 ID 取模定位后线性探测，请求路径上没有字符串哈希和内存分配。
+ * 不同方法的 ID 冲突时无法区分，直接退出。
+ */
+void RpcProvider::AddMethodId(uint32_t method_id, google::protobuf::Service *service,
+                              const google::protobuf::MethodDescriptor *method)
+{
+    std::vector<MethodEntry> entries;
+    for (const MethodEntry &entry : m_methodTable)
+    {
+        if (entry.m_methodId == 0)
+        {
+            continue;
+        }
+        if (entry.m_methodId == method_id)
+        {
+            std::cout << "method id conflict: " << entry.m_method->full_name()
+                      << " and " << method->full_name() << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        entries.push_back(entry);
+    }
+    entries.push_back({method_id, service, method});
+
+    size_t capacity = 8;
+    while (capacity < entries.size() * 2)
+    {
+        capacity <<= 1;
+    }
+    m_methodTable.assign(capacity, MethodEntry{0, nullptr, nullptr});
+    for (const MethodEntry &entry : entries)
+    {
+        size_t idx = entry.m_methodId & (capacity - 1);
+        while (m_methodTable[idx].m_methodId != 0)
+        {
+            idx = (idx + 1) & (capacity - 1);
+        }
+        m_methodTable[idx] = entry;
+    }
+}
+
+// 按方法 ID 查找分发表，找不到返回 nullptr
+const RpcProvider::MethodEntry *RpcProvider::FindMethod(uint32_t method_id) const
+{
+    if (m_methodTable.empty())
+    {
+        return nullptr;
+    }
+    size_t mask = m_methodTable.size() - 1;
+    for (size_t idx = method_id & mask;; idx = (idx + 1) & mask)
+    {
+        const MethodEntry &entry = m_methodTable[idx];
+        if (entry.m_methodId == method_id)
+        {
+            return &entry;
+        }
+        if (entry.m_methodId == 0)
+        {
+            return nullptr;
+        }
+    }
+}
+
 // ---------------------------- 服务启动方法 ----------------------------
 /**
  * @brief 启动 RPC 服务端
@@ -68,9 +200,58 @@ void RpcProvider::Run()
                                         std::placeholders::_2,   // Buffer*
                                         std::placeholders::_3)); // Timestamp
 
-    // 设置线程数（I/O 线程与工作线程分离）
-    server.setThreadNum(4); // 通常设置为 CPU 核心数
+    // 写完成回调：输出缓冲区清空后恢复因高水位暂停的读取
+    server.setWriteCompleteCallback(std::bind(&RpcProvider::OnWriteComplete, this, std::placeholders::_1));
+
+    // 每个连接输出缓冲区的高水位，未配置时默认 64MB
+    std::string high_water_mark = MprpcApplication::getInstance().GetConfig().Load("rpchighwatermark");
+    m_highWaterMark = high_water_mark.empty() ? kDefaultHighWaterMark : strtoull(high_water_mark.c_str(), nullptr, 10);
+
+    // 设置 I/O 线程数，未配置时默认 4 个
+    std::string io_threads = MprpcApplication::getInstance().GetConfig().Load("rpciothreads");
+    server.setThreadNum(io_threads.empty() ? kDefaultIoThreads : atoi(io_threads.c_str()));
 
+    // 业务线程池：配置了 rpcworkerthreads 时，服务方法在业务线程执行，不阻塞 I/O 线程；
+    // 未配置或为 0 时仍在 I/O 线程内直接执行
+    int worker_threads = atoi(MprpcApplication::getInstance().GetConfig().Load("rpcworkerthreads").c_str());
+    if (worker_threads > 0)
+    {
+        std::string queue_size = MprpcApplication::getInstance().GetConfig().Load("rpcworkerqueuesize");
+        m_workerPool.reset(new ThreadPool(worker_threads,
+                                          queue_size.empty() ? kDefaultWorkerQueueSize : atoi(queue_size.c_str())));
+        m_workerPool->Start();
+    }
+
+    // 启动监听，之后再注册：客户端查到服务端时连接已经可以建立
+    server.start();
+
+    // 配置了 rpcunixpath 时同时监听 Unix 域套接字，连接同样分配到 I/O 线程；
+    // 本机的客户端经由它通信，省去回环 TCP 协议栈的开销
+    std::string unix_path = MprpcApplication::getInstance().GetConfig().Load("rpcunixpath");
+    std::unique_ptr<UnixAcceptor> unix_acceptor;
+    if (!unix_path.empty())
+    {
+        unix_acceptor.reset(new UnixAcceptor(&m_eventLoop, unix_path, "RpcProvider"));
+        unix_acceptor->setConnectionCallback(std::bind(&RpcProvider::OnConnection, this, std::placeholders::_1));
+        unix_acceptor->setMessageCallback(std::bind(&RpcProvider::OnMessage, this, std::placeholders::_1,
+                                                    std::placeholders::_2, std::placeholders::_3));
+        unix_acceptor->setWriteCompleteCallback(std::bind(&RpcProvider::OnWriteComplete, this, std::placeholders::_1));
+        if (!unix_acceptor->Start(server.threadPool()))
+        {
+            unix_acceptor.reset();
+        }
+    }
+
+    // 注册到 ZooKeeper：方法节点是永久节点，每个服务端在其下创建一个临时顺序子节点，
+    // 同一方法可以由多个服务端提供，客户端在它们之间做负载均衡。
+    // 监听了 Unix 域套接字时一并发布路径和主机名，同一主机上的客户端据此改用 Unix 域套接字
+    std::string weight = MprpcApplication::getInstance().GetConfig().Load("rpcserverweight");
+    std::string provider_data = ip + ":" + std::to_string(port) + ";weight=" +
+                                std::to_string(weight.empty() ? 1 : atoi(weight.c_str()));
+    if (unix_acceptor)
+    {
+        provider_data += ";unix=" + unix_path + ";host=" + LocalHostName();
+    }
     ZkClient zkCli;
     zkCli.Start();
 
@@ -81,15 +262,19 @@ void RpcProvider::Run()
         for (auto &mp : sp.second.m_methodMap)
         {
             std::string method_path = service_path + "/" + mp.first;
-            char method_path_data[128] = {0};
-            sprintf(method_path_data, "%s:%d", ip.c_str(), port);
-            zkCli.Create(method_path.c_str(), method_path_data, strlen(method_path_data), ZOO_EPHEMERAL);
+            zkCli.Create(method_path.c_str(), nullptr, 0);
+
+            std::string provider_path = method_path + "/provider-";
+            zkCli.Create(provider_path.c_str(), provider_data.c_str(), provider_data.size(), ZOO_EPHEMERAL | ZOO_SEQUENCE);
         }
     }
 
     // 启动服务
     std::cout << "RpcProvider start service at ip:" << ip << " port:" << port << std::endl;
-    server.start();     // 启动监听
+    if (unix_acceptor)
+    {
+        std::cout << "RpcProvider start service at unix:" << unix_path << std::endl;
+    }
     m_eventLoop.loop(); // 进入事件循环
 }
 
@@ -98,127 +283,616 @@ void RpcProvider::Run()
  * @brief 处理连接状态变化
  * @param conn TCP 连接对象
  *
- * 当连接断开时主动关闭
+ * 新连接设置输出缓冲区高水位回调；当连接断开时主动关闭
  */
 void RpcProvider::OnConnection(const muduo::net::TcpConnectionPtr &conn)
 {
-    if (!conn->connected())
-    {                     // 连接断开处理
-        conn->shutdown(); // 关闭连接（muduo 自动管理资源）
+    if (conn->connected())
+    {
+        conn->setHighWaterMarkCallback(std::bind(&RpcProvider::OnHighWaterMark, this,
+                                                 std::placeholders::_1, std::placeholders::_2),
+                                       m_highWaterMark);
+        conn->setContext(std::make_shared<ConnectionState>());
+    }
+    else
+    {                                // 连接断开处理
+        CancelCalls(conn, 0, true); // 客户端已不再等待，取消该连接上所有正在执行的调用
+        conn->shutdown();           // 关闭连接（muduo 自动管理资源）
+    }
+}
+
+/**
+ * @brief 输出缓冲区超过高水位
+ *
+ * 客户端读得比我们写得慢时，待发送的响应在输出缓冲区中不断堆积。
+ * 此时暂停读取该连接的新请求，不再产生新的响应，内存占用因此有上界；
+ * 缓冲区写空后由 OnWriteComplete 恢复读取。
+ */
+void RpcProvider::OnHighWaterMark(const muduo::net::TcpConnectionPtr &conn, size_t len)
+{
+    if (conn->isReading())
+    {
+        std::cout << "connection " << conn->name() << " output buffer " << len
+                  << " bytes reach high water mark, stop reading" << std::endl;
+        conn->stopRead();
+    }
+}
+
+// 输出缓冲区已写空，恢复读取
+void RpcProvider::OnWriteComplete(const muduo::net::TcpConnectionPtr &conn)
+{
+    if (!conn->isReading())
+    {
+        conn->startRead();
     }
 }
 
 // ---------------------------- 核心消息处理 ----------------------------
 /**
- * @brief 处理接收到的 RPC 请求
+ * @brief 处理接收到的 RPC 请求（增量解帧）
  * @param conn TCP 连接对象
  * @param buffer 接收缓冲区
  * @param 时间戳（未使用）
  *
  * 协议格式：
  * [4字节头部长度] [RPC头部] [参数数据]
+ *
+ * TCP 是字节流，一次回调可能只收到半个请求（拆包），也可能收到多个请求（粘包）。
+ * 这里先 peek 4 字节头部长度，等头部收全后解析出 args_size，
+ * 再等整帧收全才取出处理；循环处理缓冲区中所有完整的帧，不完整的部分留在 buffer 中等待下次回调。
  */
 void RpcProvider::OnMessage(const muduo::net::TcpConnectionPtr &conn,
                             muduo::net::Buffer *buffer,
                             muduo::Timestamp)
 {
-    // 获取完整数据包
-    std::string recv_buf = buffer->retrieveAllAsString();
+    while (buffer->readableBytes() >= kRpcHeaderLenBytes)
+    {
+        // 解析协议头部长度（存在字节序问题，见改进建议）
+        uint32_t header_size = 0;
+        memcpy(&header_size, buffer->peek(), kRpcHeaderLenBytes);
+        if (header_size > kRpcMaxHeaderSize)
+        { // 非法长度，无法再对齐后续帧，直接断开
+            std::cout << "rpc header size invalid: " << header_size << std::endl;
+            buffer->retrieveAll();
+            conn->shutdown();
+            return;
+        }
+        if (buffer->readableBytes() < kRpcHeaderLenBytes + header_size)
+        {
+            break; // 头部未收全，等待更多数据
+        }
 
-    // 解析协议头部长度（存在字节序问题，见改进建议）
-    uint32_t header_size = 0;
-    recv_buf.copy((char *)&header_size, 4, 0); // 前4字节为头部长度
+        // 解析 RPC 协议头（直接在缓冲区上解析，头部未收全前不会走到这里）
+        mprpc::RpcHeader rpcHeader;
+        if (!rpcHeader.ParseFromArray(buffer->peek() + kRpcHeaderLenBytes, header_size))
+        { // 反序列化协议头
+            std::cout << "rpc header parse error, header_size: " << header_size << std::endl;
+            buffer->retrieveAll();
+            conn->shutdown(); // 协议错误，断开连接
+            return;
+        }
 
-    // 解析 RPC 协议头
-    std::string rpc_header_str = recv_buf.substr(4, header_size);
-    mprpc::RpcHeader rpcHeader;
-    std::string service_name, method_name;
-    uint32_t args_size;
+        uint32_t args_size = rpcHeader.args_size();
+        if (args_size > kRpcMaxArgsSize)
+        {
+            std::cout << "rpc args size invalid: " << args_size << std::endl;
+            buffer->retrieveAll();
+            conn->shutdown();
+            return;
+        }
+        size_t frame_size = kRpcHeaderLenBytes + header_size + args_size;
+        if (buffer->readableBytes() < frame_size)
+        {
+            break; // 参数未收全，等待更多数据
+        }
 
-    if (!rpcHeader.ParseFromString(rpc_header_str))
-    { // 反序列化协议头
-        std::cout << "rpc_header_str parse error: " << rpc_header_str << std::endl;
-        return; // 协议错误直接返回
+        // 参数直接在缓冲区上反序列化，分发完成后才从缓冲区中移除整帧
+        const char *args = buffer->peek() + kRpcHeaderLenBytes + header_size;
+        if (rpcHeader.frame_type() == mprpc::RPC_FRAME_BATCH)
+        {
+            HandleBatch(conn, rpcHeader, args);
+        }
+        else if (rpcHeader.frame_type() == mprpc::RPC_FRAME_CANCEL)
+        {
+            CancelCalls(conn, rpcHeader.request_id(), false);
+        }
+        else
+        {
+            HandleRequest(conn, rpcHeader, args, args_size, nullptr, 0);
+        }
+        buffer->retrieve(frame_size);
     }
-    service_name = rpcHeader.service_name();
-    method_name = rpcHeader.method_name();
-    args_size = rpcHeader.args_size();
+}
 
-    // 提取参数数据
-    std::string args_str = recv_buf.substr(4 + header_size, args_size);
+// ---------------------------- 请求分发方法 ----------------------------
+/**
+ * @brief 处理一个完整的 RPC 请求
+ * @param conn TCP 连接对象
+ * @param rpcHeader 已解析的 RPC 协议头
+ * @param args 参数数据，指向接收缓冲区（或批量帧）内部
+ * @param args_size 参数长度
+ * @param batch 所属的批量请求，单个请求为 nullptr
+ * @param batch_index 在批量请求中的序号
+ *
+ * 参数在本函数内（I/O 线程中）反序列化到请求对象，返回后 args 即失效，
+ * 投递到业务线程的只有已解析好的请求对象。
+ */
+void RpcProvider::HandleRequest(const muduo::net::TcpConnectionPtr &conn,
+                                const mprpc::RpcHeader &rpcHeader,
+                                const char *args, size_t args_size,
+                                BatchCall *batch, int batch_index)
+{
+    // 出错时单个请求直接回复错误，批量请求中的一项则把错误写入对应槽位
+    auto reject = [&](mprpc::RpcErrorCode error_code, const std::string &error_text)
+    {
+        if (batch != nullptr)
+        {
+            FailBatchItem(batch, batch_index, error_code, error_text);
+        }
+        else
+        {
+            SendRpcError(conn, rpcHeader.request_id(), error_code, error_text);
+        }
+    };
+
+    google::protobuf::Service *service = nullptr;
+    const google::protobuf::MethodDescriptor *method = nullptr;
+
+    if (rpcHeader.method_id() != 0)
+    {
+        // 新客户端只携带方法 ID，直接查分发表
+        const MethodEntry *entry = FindMethod(rpcHeader.method_id());
+        if (entry == nullptr)
+        {
+            std::cout << "Method id not found: " << rpcHeader.method_id() << std::endl;
+            reject(mprpc::RPC_METHOD_NOT_FOUND, "method id not found: " + std::to_string(rpcHeader.method_id()));
+            return;
+        }
+        service = entry->m_service;
+        method = entry->m_method;
+    }
+    else
+    {
+        // 兼容旧客户端：按服务名/方法名查找
+        const std::string &service_name = rpcHeader.service_name();
+        const std::string &method_name = rpcHeader.method_name();
+
+        // 服务查找验证
+        auto sit = m_serviceMap.find(service_name);
+        if (sit == m_serviceMap.end())
+        {
+            std::cout << "Service not found: " << service_name << std::endl;
+            reject(mprpc::RPC_SERVICE_NOT_FOUND, "service not found: " + service_name);
+            return;
+        }
+
+        // 方法查找验证
+        auto mit = sit->second.m_methodMap.find(method_name);
+        if (mit == sit->second.m_methodMap.end())
+        {
+            std::cout << "Method not found: " << service_name << ":" << method_name << std::endl;
+            reject(mprpc::RPC_METHOD_NOT_FOUND, "method not found: " + service_name + ":" + method_name);
+            return;
+        }
+        service = sit->second.m_service;
+        method = mit->second;
+    }
 
     // 调试输出（建议改为日志级别控制）
     std::cout << "=============== RPC 请求 ===============" << std::endl;
-    std::cout << "header_size: " << header_size << std::endl;
-    std::cout << "service_name: " << service_name << std::endl;
-    std::cout << "method_name: " << method_name << std::endl;
+    std::cout << "method: " << method->full_name() << std::endl;
     std::cout << "args_size: " << args_size << std::endl;
     std::cout << "========================================" << std::endl;
 
-    // 服务查找验证
-    auto sit = m_serviceMap.find(service_name);
-    if (sit == m_serviceMap.end())
+    // 请求/响应对象及调用上下文都分配在本线程缓存的 Arena 上，在 SendRpcResponse 中整体释放
+    RpcArena *rpcArena = AcquireArena();
+    google::protobuf::Message *request = service->GetRequestPrototype(method).New(&rpcArena->m_arena);
+    if (!request->ParseFromArray(args, args_size))
+    { // 反序列化参数
+        std::cout << "Request parse error, args_size: " << args_size << std::endl;
+        reject(mprpc::RPC_REQUEST_PARSE_ERROR, "request parse error");
+        ReleaseArena(rpcArena);
+        return;
+    }
+
+    RpcCall *call = google::protobuf::Arena::Create<RpcCall>(&rpcArena->m_arena);
+    call->m_requestId = rpcHeader.request_id();
+    call->m_arena = rpcArena;
+    call->m_batch = batch;
+    call->m_batchIndex = batch_index;
+    call->m_controller = google::protobuf::Arena::Create<MprpcController>(&rpcArena->m_arena);
+    call->m_errorCode = mprpc::RPC_OK;
+    call->m_request = request;
+    call->m_response = service->GetResponsePrototype(method).New(&rpcArena->m_arena);
+    if (rpcHeader.timeout_ms() > 0)
+    {
+        // 客户端的剩余时间从现在开始计时，服务方法也可以通过 controller 查询剩余时间
+        call->m_controller->SetTimeout(rpcHeader.timeout_ms());
+    }
+
+    // 完成回调：服务方法可以在任意线程、在 CallMethod 返回之后调用
+    google::protobuf::Closure *done = new RpcDoneClosure(this, conn, call);
+    RegisterCall(conn, call);
+
+    // 调用服务方法：有业务线程池时投递到队列，队列满则直接拒绝，避免 I/O 线程被阻塞
+    if (m_workerPool)
     {
-        std::cout << "Service not found: " << service_name << std::endl;
+        bool posted = m_workerPool->TryRun([service, method, call, done]()
+                                           { InvokeMethod(service, method, call, done); });
+        if (!posted)
+        {
+            std::cout << "worker queue is full, reject: " << method->full_name() << std::endl;
+            // 先注销再归还 Arena，否则之后的取消会访问已释放的 controller
+            UnregisterCall(conn, call);
+            delete done;
+            ReleaseArena(rpcArena);
+            reject(mprpc::RPC_SERVER_BUSY, "server busy");
+        }
         return;
     }
+    InvokeMethod(service, method, call, done);
+}
 
-    // 方法查找验证
-    auto mit = sit->second.m_methodMap.find(method_name);
-    if (mit == sit->second.m_methodMap.end())
+/**
+ * @brief 执行服务方法
+ *
+ * 请求在业务队列中排队期间可能已超过客户端的截止时间，客户端已经放弃等待，
+ * 此时不再执行服务方法，直接返回 RPC_DEADLINE_EXCEEDED。
+ */
+void RpcProvider::InvokeMethod(google::protobuf::Service *service, const google::protobuf::MethodDescriptor *method,
+                               RpcCall *call, google::protobuf::Closure *done)
+{
+    if (call->m_controller->DeadlineExceeded())
+    {
+        std::cout << "deadline exceeded, drop: " << method->full_name() << std::endl;
+        call->m_errorCode = mprpc::RPC_DEADLINE_EXCEEDED;
+        call->m_controller->SetFailed("deadline exceeded");
+        done->Run();
+        return;
+    }
+    if (call->m_controller->IsCanceled())
     {
-        std::cout << "Method not found: " << service_name << ":" << method_name << std::endl;
+        std::cout << "canceled, drop: " << method->full_name() << std::endl;
+        call->m_errorCode = mprpc::RPC_CANCELED;
+        call->m_controller->SetFailed("canceled");
+        done->Run();
         return;
     }
+    service->CallMethod(method, call->m_controller, call->m_request, call->m_response, done);
+}
 
-    // 准备请求/响应对象
-    google::protobuf::Service *service = sit->second.m_service;
-    const google::protobuf::MethodDescriptor *method = mit->second;
+// ---------------------------- 取消 ----------------------------
+// 连接的状态，OnConnection 中设置，之后只读，任意线程可以访问
+RpcProvider::ConnectionState *RpcProvider::GetConnectionState(const muduo::net::TcpConnectionPtr &conn)
+{
+    const ConnectionStatePtr *state = boost::any_cast<ConnectionStatePtr>(&conn->getContext());
+    return state != nullptr ? state->get() : nullptr;
+}
 
-    // 创建动态消息对象（需要手动管理内存，见改进建议）
-    google::protobuf::Message *request = service->GetRequestPrototype(method).New();
-    if (!request->ParseFromString(args_str))
-    { // 反序列化参数
-        std::cout << "Request parse error: " << args_str << std::endl;
-        delete request; // 防止内存泄漏
+// 登记正在执行的调用，之后可以被取消帧或连接断开取消。
+// 批量请求的各项按整批的 request_id 登记；短连接请求的 request_id 为 0，只会因连接断开被取消
+void RpcProvider::RegisterCall(const muduo::net::TcpConnectionPtr &conn, RpcCall *call)
+{
+    uint64_t key = call->m_batch != nullptr ? call->m_batch->m_requestId : call->m_requestId;
+    ConnectionState *state = GetConnectionState(conn);
+    if (state == nullptr)
+    {
+        return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(state->m_mutex);
+    state->m_inflight.emplace(key, call->m_controller);
+}
+
+// 调用结束，释放 Arena 之前注销，此后取消不会再访问它的 controller
+void RpcProvider::UnregisterCall(const muduo::net::TcpConnectionPtr &conn, RpcCall *call)
+{
+    uint64_t key = call->m_batch != nullptr ? call->m_batch->m_requestId : call->m_requestId;
+    ConnectionState *state = GetConnectionState(conn);
+    if (state == nullptr)
+    {
+        return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(state->m_mutex);
+    auto range = state->m_inflight.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second == call->m_controller)
+        {
+            state->m_inflight.erase(it);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 取消连接上 request_id 对应的调用（all 为 true 时取消全部），在 I/O 线程中执行
+ *
+ * 持锁期间调用方法不会结束释放，controller 一直有效；服务方法的取消回调中可能直接结束调用，
+ * 在本线程再次进入 UnregisterCall，所以使用可重入锁，并先把要取消的 controller 拷贝出来。
+ * 尚未开始执行的调用在 InvokeMethod 中检查到已取消，不再执行服务方法。
+ */
+void RpcProvider::CancelCalls(const muduo::net::TcpConnectionPtr &conn, uint64_t request_id, bool all)
+{
+    ConnectionState *state = GetConnectionState(conn);
+    if (state == nullptr)
+    {
+        return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(state->m_mutex);
+    std::vector<MprpcController *> controllers;
+    if (all)
+    {
+        for (auto &inflight : state->m_inflight)
+        {
+            controllers.push_back(inflight.second);
+        }
+    }
+    else
+    {
+        auto range = state->m_inflight.equal_range(request_id);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            controllers.push_back(it->second);
+        }
+    }
+    for (MprpcController *controller : controllers)
+    {
+        controller->StartCancel();
+    }
+}
+
+// ---------------------------- 批量请求 ----------------------------
+/**
+ * @brief 处理批量请求帧
+ *
+ * 数据部分是 RpcBatch，每一项按单个请求分发；有业务线程池时各项分别投递，并行执行。
+ * 每项完成后把结果写入自己的槽位，最后完成的一项负责整批发送，响应各项顺序与请求一致。
+ * 批量帧的响应需要 request_id 匹配，只支持长连接模式。
+ */
+void RpcProvider::HandleBatch(const muduo::net::TcpConnectionPtr &conn,
+                              const mprpc::RpcHeader &rpcHeader,
+                              const char *args)
+{
+    if (rpcHeader.request_id() == 0)
+    {
+        std::cout << "batch request without request_id" << std::endl;
+        conn->shutdown();
+        return;
+    }
+
+    mprpc::RpcBatch requests;
+    if (!requests.ParseFromArray(args, rpcHeader.args_size()) || requests.items_size() == 0)
+    {
+        std::cout << "Batch parse error, args_size: " << rpcHeader.args_size() << std::endl;
+        SendRpcError(conn, rpcHeader.request_id(), mprpc::RPC_REQUEST_PARSE_ERROR, "batch parse error");
+        return;
+    }
+
+    int count = requests.items_size();
+    BatchCall *batch = new BatchCall;
+    batch->m_conn = conn;
+    batch->m_requestId = rpcHeader.request_id();
+    batch->m_pending = count;
+    batch->m_arenas.assign(count, nullptr);
+    for (int i = 0; i < count; ++i)
+    {
+        batch->m_responses.add_items();
+    }
+
+    // 最后一项完成时 batch 会被释放，分发之后不能再访问 batch
+    for (int i = 0; i < count; ++i)
+    {
+        // 各项没有单独的时间预算时沿用整批的
+        mprpc::RpcBatchItem *item = requests.mutable_items(i);
+        if (item->header().timeout_ms() == 0)
+        {
+            item->mutable_header()->set_timeout_ms(rpcHeader.timeout_ms());
+        }
+        HandleRequest(conn, item->header(), item->args().data(), item->args().size(), batch, i);
+    }
+}
+
+// 批量请求中的一项在分发前就失败了：写入错误信息并计为完成
+void RpcProvider::FailBatchItem(BatchCall *batch, int index, mprpc::RpcErrorCode error_code, const std::string &error_text)
+{
+    mprpc::RpcHeader *itemHeader = batch->m_responses.mutable_items(index)->mutable_header();
+    itemHeader->set_error_code(error_code);
+    itemHeader->set_error_text(error_text);
+    FinishBatchItem(batch);
+}
+
+/**
+ * @brief 批量请求中的一项执行完成，把结果写入对应槽位
+ *
+ * 各项可能在不同的业务线程上同时完成，但每个槽位只被一个线程写入；
+ * Arena 先记在 batch 中，整批发送后在 I/O 线程统一归还。
+ */
+void RpcProvider::CompleteBatchItem(RpcCall *call)
+{
+    BatchCall *batch = call->m_batch;
+    mprpc::RpcBatchItem *item = batch->m_responses.mutable_items(call->m_batchIndex);
+    if (call->m_controller->Failed())
+    {
+        item->mutable_header()->set_error_code(call->m_errorCode != mprpc::RPC_OK ? call->m_errorCode : mprpc::RPC_CALL_FAILED);
+        item->mutable_header()->set_error_text(call->m_controller->ErrorText());
+    }
+    else
+    {
+        call->m_response->SerializeToString(item->mutable_args());
+        item->mutable_header()->set_args_size(item->args().size());
+    }
+    batch->m_arenas[call->m_batchIndex] = call->m_arena;
+    FinishBatchItem(batch);
+}
+
+// 完成计数减一，最后一项完成时组帧并交给 I/O 线程发送
+void RpcProvider::FinishBatchItem(BatchCall *batch)
+{
+    if (--batch->m_pending > 0)
+    {
         return;
     }
 
-    google::protobuf::Message *response = service->GetResponsePrototype(method).New();
+    std::shared_ptr<muduo::net::Buffer> send_buffer = std::make_shared<muduo::net::Buffer>();
+    mprpc::RpcHeader rpcHeader;
+    rpcHeader.set_request_id(batch->m_requestId);
+    rpcHeader.set_frame_type(mprpc::RPC_FRAME_BATCH);
+    EncodeRpcFrame(&rpcHeader, &batch->m_responses, send_buffer.get());
 
-    // 创建回调闭包（使用 NewCallback 绑定响应发送方法）
-    google::protobuf::Closure *done = google::protobuf::NewCallback<RpcProvider,
-                                                                    const muduo::net::TcpConnectionPtr &,
-                                                                    google::protobuf::Message *>(
-        this,
-        &RpcProvider::SendRpcResponse, // 回调方法
-        conn,                          // 保持连接引用
-        response                       // 响应对象所有权转移
-    );
+    batch->m_conn->getLoop()->runInLoop([batch, send_buffer]()
+                                        {
+        batch->m_conn->send(send_buffer.get());
+        for (RpcArena *rpcArena : batch->m_arenas)
+        {
+            if (rpcArena != nullptr)
+            {
+                ReleaseArena(rpcArena);
+            }
+        }
+        delete batch; });
+}
 
-    // 调用服务方法（异步处理）
-    service->CallMethod(method, nullptr, request, response, done);
+// ---------------------------- 完成回调 ----------------------------
+/**
+ * 服务方法可以把 done 交给自己的异步后端，在任意线程、任意时刻调用 done->Run()。
+ * 在此之前 request/response/controller 都保持有效（它们在 Arena 上，Arena 在发送后才归还）；
+ * Run() 只负责序列化，连接相关的操作都由 SendRpcResponse 转回连接所属的 I/O 线程执行。
+ */
+RpcProvider::RpcDoneClosure::RpcDoneClosure(RpcProvider *provider, const muduo::net::TcpConnectionPtr &conn, RpcCall *call)
+    : m_provider(provider), m_conn(conn), m_call(call)
+{
+}
+
+void RpcProvider::RpcDoneClosure::Run()
+{
+    // 先取出成员再释放自身，Run 只能调用一次
+    RpcProvider *provider = m_provider;
+    muduo::net::TcpConnectionPtr conn = std::move(m_conn);
+    RpcCall *call = m_call;
+    delete this;
+
+    provider->SendRpcResponse(conn, call);
 }
 
 // ---------------------------- 响应发送方法 ----------------------------
 /**
  * @brief 发送 RPC 响应
  * @param conn TCP 连接
- * @param response 响应消息对象
+ * @param call 调用上下文（请求/响应对象、请求序号）
+ *
+ * 注意：此方法在服务方法执行完成后由 RpcDoneClosure 触发，可能运行在业务线程或服务自己的线程。
+ * 序列化在当前线程完成，发送和 Arena 归还通过 runInLoop 回到连接所属的 I/O 线程执行，
+ * Arena 因此总是回到分配它的 I/O 线程缓存中。
  *
- * 注意：此方法在服务方法执行完成后由闭包触发
+ * 响应按 [4字节头部长度] [RPC头部] [响应数据] 组帧，客户端按长度读取，响应大小不受限制。
+ * 短连接模式（request_id 为 0）：发送后关闭连接；
+ * 长连接模式：连接保持，客户端根据头部中的 request_id 匹配对应的请求。
  */
-void RpcProvider::SendRpcResponse(const muduo::net::TcpConnectionPtr &conn,
-                                  google::protobuf::Message *response)
+void RpcProvider::SendRpcResponse(const muduo::net::TcpConnectionPtr &conn, RpcCall *call)
 {
-    std::string response_str;
-    if (response->SerializeToString(&response_str))
-    {                             // 序列化响应
-        conn->send(response_str); // 通过 muduo 发送数据
+    // 调用结束：不再接受取消，执行尚未触发的取消回调
+    UnregisterCall(conn, call);
+    call->m_controller->RunCancelCallbacks();
+
+    if (call->m_batch != nullptr)
+    {
+        CompleteBatchItem(call);
+        return;
     }
-    else
+
+    muduo::net::EventLoop *loop = conn->getLoop();
+    if (loop->isInLoopThread())
+    {
+        // 已在 I/O 线程：序列化到线程复用的缓冲区后直接发送，send 会把未写完的部分追加到输出缓冲区
+        static thread_local muduo::net::Buffer t_sendBuffer;
+        EncodeRpcResponse(call, &t_sendBuffer);
+        FinishRpcCall(conn, call, &t_sendBuffer);
+        return;
+    }
+
+    // 业务线程：在本线程序列化，再把缓冲区交给 I/O 线程发送
+    std::shared_ptr<muduo::net::Buffer> send_buffer = std::make_shared<muduo::net::Buffer>();
+    EncodeRpcResponse(call, send_buffer.get());
+    loop->runInLoop([conn, call, send_buffer]()
+                    { FinishRpcCall(conn, call, send_buffer.get()); });
+}
+
+/**
+ * @brief 把响应序列化到 buffer
+ *
+ * 先用 ByteSizeLong 算出长度并预留空间，再用 SerializeWithCachedSizesToArray
+ * 直接写入缓冲区，长度前缀和头部写在同一块内存中，不经过临时 std::string。
+ */
+void RpcProvider::EncodeRpcResponse(RpcCall *call, muduo::net::Buffer *buffer)
+{
+    if (call->m_controller->Failed())
+    {
+        // 服务方法通过 controller 报告失败：返回错误码和错误信息
+        std::cout << "rpc call failed: " << call->m_controller->ErrorText() << std::endl;
+        mprpc::RpcHeader rpcHeader;
+        rpcHeader.set_request_id(call->m_requestId);
+        rpcHeader.set_error_code(call->m_errorCode != mprpc::RPC_OK ? call->m_errorCode : mprpc::RPC_CALL_FAILED);
+        rpcHeader.set_error_text(call->m_controller->ErrorText());
+        EncodeRpcFrame(&rpcHeader, nullptr, buffer);
+        return;
+    }
+
+    mprpc::RpcHeader rpcHeader;
+    rpcHeader.set_request_id(call->m_requestId);
+    EncodeRpcFrame(&rpcHeader, call->m_response, buffer);
+}
+
+// 在连接所属的 I/O 线程中发送响应并结束本次调用
+void RpcProvider::FinishRpcCall(const muduo::net::TcpConnectionPtr &conn, RpcCall *call, muduo::net::Buffer *buffer)
+{
+    conn->send(buffer); // 发送后 buffer 被清空
+    if (call->m_requestId == 0)
+    {
+        conn->shutdown(); // 短连接模式，关闭连接
+    }
+    // 请求、响应和 call 本身都在 Arena 上，归还 Arena 即全部释放
+    ReleaseArena(call->m_arena);
+}
+
+/**
+ * @brief 向客户端返回错误帧，短连接模式下随后关闭连接
+ */
+void RpcProvider::SendRpcError(const muduo::net::TcpConnectionPtr &conn, uint64_t request_id,
+                               mprpc::RpcErrorCode error_code, const std::string &error_text)
+{
+    mprpc::RpcHeader rpcHeader;
+    rpcHeader.set_request_id(request_id);
+    rpcHeader.set_error_code(error_code);
+    rpcHeader.set_error_text(error_text);
+
+    muduo::net::Buffer buffer;
+    EncodeRpcFrame(&rpcHeader, nullptr, &buffer);
+    conn->send(&buffer);
+    if (request_id == 0)
+    {
+        conn->shutdown();
+    }
+}
+
+/**
+ * @brief 按 [4字节头部长度] [RPC头部] [数据] 组帧，直接写入 buffer
+ * @param rpcHeader RPC 头部，args_size 由本函数按 payload 填写
+ * @param payload 数据，可以为空
+ */
+void RpcProvider::EncodeRpcFrame(mprpc::RpcHeader *rpcHeader, const google::protobuf::Message *payload,
+                                 muduo::net::Buffer *buffer)
+{
+    size_t payload_size = payload != nullptr ? payload->ByteSizeLong() : 0;
+    rpcHeader->set_args_size(payload_size);
+    uint32_t header_size = rpcHeader->ByteSizeLong();
+
+    buffer->ensureWritableBytes(kRpcHeaderLenBytes + header_size + payload_size);
+    buffer->append(&header_size, kRpcHeaderLenBytes);
+    uint8_t *target = reinterpret_cast<uint8_t *>(buffer->beginWrite());
+    target = rpcHeader->SerializeWithCachedSizesToArray(target);
+    if (payload != nullptr)
     {
-        std::cout << "Serialize response failed!" << std::endl;
+        payload->SerializeWithCachedSizesToArray(target);
     }
-    conn->shutdown(); // 短连接模式，关闭连接
+    buffer->hasWritten(header_size + payload_size);
 }
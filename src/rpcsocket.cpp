@@ -0,0 +1,66 @@
+#include "rpcsocket.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+
+using Clock = std::chrono::steady_clock;
+
+int64_t RemainingMs(Clock::time_point deadline)
+{
+    Clock::time_point now = Clock::now();
+    if (now >= deadline)
+    {
+        return 0;
+    }
+    return (std::chrono::duration_cast<std::chrono::microseconds>(deadline - now).count() + 999) / 1000;
+}
+
+bool WaitFd(int fd, short events, Clock::time_point deadline)
+{
+    if (deadline == kNoDeadline)
+    {
+        return true;
+    }
+    for (;;)
+    {
+        int64_t remaining = RemainingMs(deadline);
+        if (remaining == 0)
+        {
+            errno = ETIMEDOUT;
+            return false;
+        }
+        struct pollfd pfd = {fd, events, 0};
+        int n = poll(&pfd, 1, remaining);
+        if (n > 0)
+            return true;
+        if (n == 0)
+        {
+            errno = ETIMEDOUT;
+            return false;
+        }
+        if (errno != EINTR)
+            return false;
+    }
+}
+
+bool ConnectWithDeadline(int fd, const struct sockaddr *addr, socklen_t addr_len, Clock::time_point deadline)
+{
+    if (deadline == kNoDeadline)
+    {
+        return connect(fd, addr, addr_len) == 0;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    if (connect(fd, addr, addr_len) == 0)
+    {
+        return true;
+    }
+    if (errno != EINPROGRESS || !WaitFd(fd, POLLOUT, deadline))
+    {
+        return false;
+    }
+    int err = 0;
+    socklen_t len = sizeof(err);
+    getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len);
+    errno = err;
+    return err == 0;
+}
@@ -0,0 +1,202 @@
+#include "servicediscovery.h"
+#include "mprpcapplication.h"
+#include "rpcaddress.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+ServiceDiscovery::ServiceDiscovery()
+{
+    m_zkClient.Start();
+    m_refreshThread = std::thread(&ServiceDiscovery::RefreshLoop, this);
+    m_refreshThread.detach();
+}
+
+ServiceDiscovery &ServiceDiscovery::getInstance()
+{
+    // 故意不析构：刷新线程和 ZooKeeper 回调会一直引用它，直到进程退出
+    static ServiceDiscovery *discovery = new ServiceDiscovery();
+    return *discovery;
+}
+
+EndpointList ServiceDiscovery::Lookup(const std::string &path)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        auto it = m_cache.find(path);
+        if (it != m_cache.end())
+        {
+            return it->second;
+        }
+    }
+
+    // 第一次查询：读取并注册监听。节点不存在时不缓存，下次查询再读
+    EndpointList endpoints;
+    if (!Fetch(path, &endpoints))
+    {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    m_cache[path] = endpoints;
+    return endpoints;
+}
+
+EndpointState *ServiceDiscovery::GetEndpointState(const std::string &host)
+{
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    std::unique_ptr<EndpointState> &state = m_states[host];
+    if (!state)
+    {
+        state.reset(new EndpointState);
+    }
+    return state.get();
+}
+
+/**
+ * @brief 从 ZooKeeper 读取方法节点下的服务端列表并注册监听
+ *
+ * 每个服务端注册一个临时顺序子节点，数据为 ip:port[;weight=N][;unix=/path;host=主机名]；
+ * 没有子节点时按旧格式读取方法节点本身的数据，兼容只注册单个地址的服务端。
+ * @return 节点不存在返回 false；节点存在但没有服务端时 endpoints 为空列表
+ */
+bool ServiceDiscovery::Fetch(const std::string &path, EndpointList *endpoints)
+{
+    std::lock_guard<std::mutex> lock(m_zkMutex);
+    std::vector<std::string> children;
+    if (!m_zkClient.GetChildren(path.c_str(), &ServiceDiscovery::DataWatcher, this, &children))
+    {
+        return false;
+    }
+
+    std::vector<ServiceEndpoint> list;
+    ServiceEndpoint endpoint;
+    if (children.empty())
+    {
+        std::string data;
+        if (m_zkClient.GetData(path.c_str(), &ServiceDiscovery::DataWatcher, this, &data) &&
+            ParseEndpoint(data, &endpoint))
+        {
+            list.push_back(endpoint);
+        }
+    }
+    for (const std::string &child : children)
+    {
+        // 子节点是临时节点，数据注册后不再变化，只需监听子节点列表
+        std::string child_path = path + "/" + child;
+        if (ParseEndpoint(m_zkClient.GetData(child_path.c_str()), &endpoint))
+        {
+            list.push_back(endpoint);
+        }
+    }
+    *endpoints = std::make_shared<const std::vector<ServiceEndpoint>>(std::move(list));
+    return true;
+}
+
+// 解析节点数据 ip:port[;key=value...]，目前识别 weight、unix 和 host
+bool ServiceDiscovery::ParseEndpoint(const std::string &data, ServiceEndpoint *endpoint)
+{
+    std::istringstream is(data);
+    std::string field;
+    if (!std::getline(is, field, ';') || field.find(":") == std::string::npos)
+    {
+        return false;
+    }
+    endpoint->m_host = field;
+    endpoint->m_weight = 1;
+    std::string unix_path;
+    std::string hostname;
+    while (std::getline(is, field, ';'))
+    {
+        int idx = field.find("=");
+        if (idx == -1)
+        {
+            continue;
+        }
+        std::string key = field.substr(0, idx);
+        std::string value = field.substr(idx + 1);
+        if (key == "weight")
+        {
+            endpoint->m_weight = std::max(atoi(value.c_str()), 1);
+        }
+        else if (key == "unix")
+        {
+            unix_path = value;
+        }
+        else if (key == "host")
+        {
+            hostname = value;
+        }
+    }
+    // 主机名相同且套接字文件可访问才认为服务端在本机，容器内主机名重复时后者可以排除误判
+    endpoint->m_address = endpoint->m_host;
+    if (!unix_path.empty() && hostname == LocalHostName() && access(unix_path.c_str(), R_OK | W_OK) == 0 &&
+        PreferUnix())
+    {
+        endpoint->m_address = kUnixAddressPrefix + unix_path;
+    }
+    endpoint->m_state = GetEndpointState(endpoint->m_host);
+    return true;
+}
+
+// 配置 rpcpreferunix 为 0 时始终经由 TCP 连接，默认优先使用 Unix 域套接字
+bool ServiceDiscovery::PreferUnix()
+{
+    static const bool prefer = MprpcApplication::getInstance().GetConfig().Load("rpcpreferunix") != "0";
+    return prefer;
+}
+
+/**
+ * @brief 监听回调，运行在 ZooKeeper 的回调线程
+ *
+ * 回调线程中调用同步接口会死锁，这里只把需要刷新的节点交给刷新线程。
+ * 会话过期后所有监听失效，通知刷新线程重建会话并清空缓存。
+ */
+void ServiceDiscovery::DataWatcher(zhandle_t *zh, int type, int state, const char *path, void *watcherCtx)
+{
+    ServiceDiscovery *discovery = static_cast<ServiceDiscovery *>(watcherCtx);
+    if (type == ZOO_SESSION_EVENT)
+    {
+        if (state == ZOO_EXPIRED_SESSION_STATE)
+        {
+            discovery->m_refreshQueue.Push("");
+        }
+        return;
+    }
+    if (type == ZOO_CHILD_EVENT || type == ZOO_CHANGED_EVENT || type == ZOO_DELETED_EVENT)
+    {
+        discovery->m_refreshQueue.Push(path);
+    }
+}
+
+// 刷新线程：重新读取变化的节点并再次注册监听，更新缓存
+void ServiceDiscovery::RefreshLoop()
+{
+    for (;;)
+    {
+        std::string path = m_refreshQueue.Pop();
+        if (path.empty())
+        {
+            std::cout << "zookeeper session expired, reconnecting" << std::endl;
+            {
+                std::lock_guard<std::mutex> lock(m_zkMutex);
+                m_zkClient.Start();
+            }
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            m_cache.clear();
+            continue;
+        }
+
+        EndpointList endpoints;
+        bool exist = Fetch(path, &endpoints);
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        if (exist)
+        {
+            m_cache[path] = endpoints;
+        }
+        else
+        {
+            m_cache.erase(path); // 节点已删除，下次查询时重新读取
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#include "singleflight.h"
+
+SingleFlight &SingleFlight::getInstance()
+{
+    static SingleFlight flight;
+    return flight;
+}
+
+SingleFlight::Shard &SingleFlight::ShardFor(const std::string &key)
+{
+    return m_shards[std::hash<std::string>()(key) % kShardCount];
+}
+
+bool SingleFlight::Join(const std::string &key, const Callback &cb)
+{
+    Shard &shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.m_mutex);
+    auto it = shard.m_flights.find(key);
+    if (it == shard.m_flights.end())
+    {
+        shard.m_flights.emplace(key, std::vector<Callback>());
+        return true;
+    }
+    it->second.push_back(cb);
+    return false;
+}
+
+void SingleFlight::Finish(const std::string &key, const std::string &error, const std::string &response_str)
+{
+    std::vector<Callback> waiters;
+    {
+        Shard &shard = ShardFor(key);
+        std::lock_guard<std::mutex> lock(shard.m_mutex);
+        auto it = shard.m_flights.find(key);
+        if (it == shard.m_flights.end())
+        {
+            return;
+        }
+        waiters.swap(it->second);
+        shard.m_flights.erase(it);
+    }
+    for (const Callback &cb : waiters)
+    {
+        cb(error, response_str);
+    }
+}
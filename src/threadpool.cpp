@@ -0,0 +1,42 @@
+#include "threadpool.h"
+
+ThreadPool::ThreadPool(int threadNum, size_t maxQueueSize)
+    : m_threadNum(threadNum), m_taskQueue(maxQueueSize)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+    // 每个工作线程收到一个空任务后退出
+    for (size_t i = 0; i < m_threads.size(); ++i)
+    {
+        m_taskQueue.Push(Task());
+    }
+    for (auto &t : m_threads)
+    {
+        t.join();
+    }
+}
+
+void ThreadPool::Start()
+{
+    for (int i = 0; i < m_threadNum; ++i)
+    {
+        m_threads.emplace_back([this]()
+                               {
+            while (true)
+            {
+                Task task = m_taskQueue.Pop();
+                if (!task)
+                {
+                    break;
+                }
+                task();
+            } });
+    }
+}
+
+bool ThreadPool::TryRun(const Task &task)
+{
+    return m_taskQueue.TryPush(task);
+}
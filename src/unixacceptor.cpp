@@ -0,0 +1,109 @@
+#include "unixacceptor.h"
+#include "rpcaddress.h"
+#include <errno.h>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+UnixAcceptor::UnixAcceptor(muduo::net::EventLoop *loop, const std::string &path, const std::string &name)
+    : m_loop(loop), m_path(path), m_name(name), m_listenFd(-1), m_nextConnId(1)
+{
+}
+
+UnixAcceptor::~UnixAcceptor()
+{
+    if (m_channel)
+    {
+        m_channel->disableAll();
+        m_channel->remove();
+    }
+    if (m_listenFd != -1)
+    {
+        close(m_listenFd);
+        unlink(m_path.c_str());
+    }
+}
+
+bool UnixAcceptor::Start(const std::shared_ptr<muduo::net::EventLoopThreadPool> &ioLoops)
+{
+    struct sockaddr_storage addr;
+    socklen_t len = ResolveRpcAddress(kUnixAddressPrefix + m_path, &addr);
+    if (len == 0)
+    {
+        std::cout << "invalid unix socket path: " << m_path << std::endl;
+        return false;
+    }
+
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listenFd == -1)
+    {
+        std::cout << "create unix socket error! errno: " << errno << std::endl;
+        return false;
+    }
+    // 上次异常退出可能留下套接字文件，不删除会 bind 失败
+    unlink(m_path.c_str());
+    if (bind(m_listenFd, (struct sockaddr *)&addr, len) != 0 || listen(m_listenFd, SOMAXCONN) != 0)
+    {
+        std::cout << "listen unix socket " << m_path << " error! errno: " << errno << std::endl;
+        close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+
+    m_ioLoops = ioLoops;
+    m_channel.reset(new muduo::net::Channel(m_loop, m_listenFd));
+    m_channel->setReadCallback([this](muduo::Timestamp)
+                               { HandleRead(); });
+    m_loop->runInLoop([this]()
+                      { m_channel->enableReading(); });
+    return true;
+}
+
+// 监听套接字可读：接受所有已完成的连接
+void UnixAcceptor::HandleRead()
+{
+    while (true)
+    {
+        int fd = accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd >= 0)
+        {
+            NewConnection(fd);
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        {
+            std::cout << "accept unix socket error! errno: " << errno << std::endl;
+        }
+        if (errno != EINTR)
+        {
+            break;
+        }
+    }
+}
+
+// 与 TcpServer::newConnection 相同：连接交给下一个 I/O 线程，断开后从连接表移除并在 I/O 线程中销毁
+void UnixAcceptor::NewConnection(int fd)
+{
+    muduo::net::EventLoop *ioLoop = m_ioLoops->getNextLoop();
+    std::string name = m_name + "-unix#" + std::to_string(m_nextConnId++);
+    muduo::net::TcpConnectionPtr conn = std::make_shared<muduo::net::TcpConnection>(
+        ioLoop, name, fd, muduo::net::InetAddress(), muduo::net::InetAddress());
+    m_connections[name] = conn;
+    conn->setConnectionCallback(m_connectionCallback);
+    conn->setMessageCallback(m_messageCallback);
+    conn->setWriteCompleteCallback(m_writeCompleteCallback);
+    conn->setCloseCallback([this](const muduo::net::TcpConnectionPtr &closed)
+                           { RemoveConnection(closed); });
+    ioLoop->runInLoop([conn]()
+                      { conn->connectEstablished(); });
+}
+
+void UnixAcceptor::RemoveConnection(const muduo::net::TcpConnectionPtr &conn)
+{
+    m_loop->runInLoop([this, conn]()
+                      {
+        m_connections.erase(conn->name());
+        conn->getLoop()->queueInLoop([conn]()
+                                     { conn->connectDestroyed(); }); });
+}
@@ -8,8 +8,10 @@ void global_watcher(zhandle_t *zh, int type, int state, const char *path, void *
     {
         if (state == ZOO_CONNECTED_STATE)
         {
+            // 只有 Start 等待期间设置了信号量，之后的断线重连不再通知
             sem_t *sem = (sem_t *)zoo_get_context(zh);
-            sem_post(sem);
+            if (sem != nullptr)
+                sem_post(sem);
         }
     }
 }
@@ -20,7 +22,7 @@ ZkClient::ZkClient() : m_zhandle(nullptr)
 
 ZkClient::~ZkClient()
 {
-    if (m_zhandle == nullptr)
+    if (m_zhandle != nullptr)
         zookeeper_close(m_zhandle);
 }
 
@@ -30,6 +32,13 @@ void ZkClient::Start()
     std::string port = MprpcApplication::getInstance().GetConfig().Load("zookeeperport");
     std::string connstr = host + ":" + port;
 
+    // 会话过期后重新 Start，先关闭旧的句柄
+    if (m_zhandle != nullptr)
+    {
+        zookeeper_close(m_zhandle);
+        m_zhandle = nullptr;
+    }
+
     m_zhandle = zookeeper_init(connstr.c_str(), global_watcher, 30000, nullptr, nullptr, 0);
     if (m_zhandle == nullptr)
     {
@@ -42,14 +51,18 @@ void ZkClient::Start()
     zoo_set_context(m_zhandle, &sem);
 
     sem_wait(&sem);
+    zoo_set_context(m_zhandle, nullptr); // sem 即将失效
     std::cout << "zookeeper_init success!!!" << std::endl;
 }
 
+// 创建节点。顺序节点每次都新建；其他节点已存在时直接使用：
+// 多个服务端同时启动时会并发创建同一个永久父节点，exists 与 create 之间被别人抢先创建不算错误
 void ZkClient::Create(const char *path, const char *data, int datalen, int state)
 {
     char path_buffer[128];
     int bufferlen = sizeof(path_buffer);
-    int flag = zoo_exists(m_zhandle, path, 0, nullptr);
+    bool sequential = (state & ZOO_SEQUENCE) != 0;
+    int flag = sequential ? ZNONODE : zoo_exists(m_zhandle, path, 0, nullptr);
     if (flag == ZNONODE) // 表示节点不存在
     {
         // 创建指定的path的znode节点
@@ -58,6 +71,10 @@ void ZkClient::Create(const char *path, const char *data, int datalen, int state
         {
             std::cout << "znode create success... path:" << path << std::endl;
         }
+        else if (flag == ZNODEEXISTS && !sequential)
+        {
+            std::cout << "znode already exists... path:" << path << std::endl;
+        }
         else
         {
             std::cout << "znode create error... path:" << path << std::endl;
@@ -68,18 +85,61 @@ void ZkClient::Create(const char *path, const char *data, int datalen, int state
 
 std::string ZkClient::GetData(const char *path)
 {
-    char buf[64];
-    int bufferlen = sizeof(buf);
-    int flag = zoo_get(m_zhandle, path, 0, buf, &bufferlen, nullptr);
-    if (flag != ZOK)
+    std::string data;
+    if (!ReadData(path, nullptr, nullptr, &data))
     {
-        std::cout << "zoo_get error" << std::endl;
-
         return "";
     }
-    else
+    return data;
+}
+
+bool ZkClient::GetData(const char *path, watcher_fn watcher, void *watcherCtx, std::string *data)
+{
+    return ReadData(path, watcher, watcherCtx, data);
+}
+
+/**
+ * @brief 读取节点数据，watcher 非空时同时注册监听
+ *
+ * zoo_get 在缓冲区不够时静默截断，这里按 Stat 中的实际长度扩大缓冲区重读；
+ * 两次读取之间节点可能被修改，仍被截断则按出错处理，不返回残缺的数据。
+ */
+bool ZkClient::ReadData(const char *path, watcher_fn watcher, void *watcherCtx, std::string *data)
+{
+    std::string buf(256, '\0');
+    for (int attempt = 0; attempt < 3; ++attempt)
+    {
+        int bufferlen = buf.size();
+        struct Stat stat;
+        int flag = watcher != nullptr
+                       ? zoo_wget(m_zhandle, path, watcher, watcherCtx, &buf[0], &bufferlen, &stat)
+                       : zoo_get(m_zhandle, path, 0, &buf[0], &bufferlen, &stat);
+        if (flag != ZOK)
+        {
+            std::cout << "zoo_get error... path:" << path << std::endl;
+            return false;
+        }
+        if (stat.dataLength <= static_cast<int>(buf.size()))
+        {
+            data->assign(buf.data(), bufferlen > 0 ? bufferlen : 0); // 节点数据不以 '\0' 结尾
+            return true;
+        }
+        buf.resize(stat.dataLength);
+    }
+    std::cout << "zoo_get error, data truncated... path:" << path << std::endl;
+    return false;
+}
+
+bool ZkClient::GetChildren(const char *path, watcher_fn watcher, void *watcherCtx, std::vector<std::string> *children)
+{
+    struct String_vector strings;
+    int flag = zoo_wget_children(m_zhandle, path, watcher, watcherCtx, &strings);
+    if (flag != ZOK)
     {
-        return buf;
+        std::cout << "zoo_wget_children error... path:" << path << std::endl;
+        return false;
     }
-    return "";
+    children->assign(strings.data, strings.data + strings.count);
+    deallocate_String_vector(&strings);
+    return true;
 }